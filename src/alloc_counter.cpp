@@ -0,0 +1,81 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstdlib>	// free, malloc
+#include <new>
+
+
+namespace AllocCounterHelper {
+
+static std::atomic<uint64_t> count{0};
+
+
+static void* allocate(std::size_t size) {
+	count.fetch_add(1, std::memory_order_relaxed);
+	if (size == 0)
+		size = 1;
+	void* p;
+	while ((p = std::malloc(size)) == nullptr) {
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+			throw std::bad_alloc{};
+		handler();
+	}
+	return p;
+}
+
+
+static void* allocateNoThrow(const std::size_t size) noexcept {
+	try {
+		return allocate(size);
+	}
+	catch (const std::bad_alloc&) {
+		return nullptr;
+	}
+}
+
+}	// namespace AllocCounterHelper
+
+
+uint64_t AllocCounter::get() {
+	return AllocCounterHelper::count.load(std::memory_order_relaxed);
+}
+
+
+void* operator new(std::size_t size) {
+	return AllocCounterHelper::allocate(size);
+}
+
+
+void* operator new[](std::size_t size) {
+	return AllocCounterHelper::allocate(size);
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return AllocCounterHelper::allocateNoThrow(size);
+}
+
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return AllocCounterHelper::allocateNoThrow(size);
+}
+
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
+
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	std::free(p);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+
+// Number of calls to the global operator new so far, from any thread.
+// The global allocation functions are replaced to count them, which costs one
+//   relaxed atomic increment per allocation.
+class AllocCounter {
+public:
+	static uint64_t get(void);
+};
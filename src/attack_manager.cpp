@@ -5,7 +5,9 @@
 #include "creature_manager.h"
 #include "player.h"
 #include "shapes.h"
+#include <algorithm>	// sort, unique
 #include <cassert>
+#include <functional>	// less
 
 
 static void damage(Creature& c, const int dmg) {
@@ -19,22 +21,47 @@ static void damage(Player& p, const int dmg) {
 }
 
 
+namespace SweepHelper {
+
+// Remove the entries whose bounds (given by getBounds) end at or before x, the
+//   order of active entries doesn't matter
+template<typename F>
+static void removeClosed(std::vector<std::size_t>& active, const int x, F getBounds) {
+	for (std::size_t i = 0; i < active.size();) {
+		const SDL_Rect bounds = getBounds(active[i]);
+		if ((bounds.x + bounds.w) <= x) {
+			active[i] = active.back();
+			active.pop_back();
+		}
+		else {
+			++i;
+		}
+	}
+}
+
+}	// namespace SweepHelper
+
+
 AttackManager::~AttackManager() {
 	for (auto p : list)
-		delete p;
+		release(p);
 	// don't delete CreatureManager
 }
 
 
 void AttackManager::update(const Constants::float_type dt) {
-	for (auto it = list.begin(); it != list.end();) {
-		if ((**it).update(dt)) {
-			delete *it;
-			it = list.erase(it);
+	// removed attacks are replaced with the last one, which is updated next
+	for (std::size_t i = 0; i < list.size();) {
+		if (list[i]->update(dt)) {
+			release(list[i]);
+			list[i] = list.back();
+			list.pop_back();
+		}
+		else {
+			++i;
 		}
-		else
-			++it;
 	}
+	resolveHits();
 }
 
 
@@ -44,49 +71,60 @@ void AttackManager::draw(Canvas& can) {
 }
 
 
+AttackRect* AttackManager::newRect() {
+	return rects.create();
+}
+
+
+SpellBasic* AttackManager::newSpellBasic(Image* img) {
+	return spellsBasic.create(img);
+}
+
+
 void AttackManager::add(Attack* a) {
 	assert(a != nullptr);
 	list.push_back(a);
 }
 
 
-bool AttackManager::procRect(const Attack* a, const SDL_Rect& rect, const int dmg) {
+// Give an attack back to its pool, attacks not from a pool are deleted
+void AttackManager::release(Attack* a) {
 	assert(a != nullptr);
+	if (!releaseFrom(rects, a) && !releaseFrom(spellsBasic, a))
+		delete a;
+}
+
+
+// Hits are resolved at the end of update()
+void AttackManager::procRect(const Attack* a, const SDL_Rect& rect, const int dmg) {
+	assert(a != nullptr);
+	const Hit hit{rect, Circle{}, dmg, false};
 	switch (a->getTarget()) {
 	case AttackTarget::NONE:
-		return false;
+		break;
 	case AttackTarget::PLAYER:
-		if (cm->intersectsPlayer(rect)) {
-			damage(*cm->getPlayer(), dmg);
-			return true;
-		}
-		else {
-			return false;
-		}
+		playerHits.push_back(hit);
+		break;
 	case AttackTarget::CREATURES:
-		return procRectCreatures(rect, dmg);
+		creatureHits.push_back(hit);
+		break;
 	}
-	return false;
 }
 
 
-bool AttackManager::procCirc(const Attack* a, const Circle& circ, const int dmg) {
+void AttackManager::procCirc(const Attack* a, const Circle& circ, const int dmg) {
 	assert(a != nullptr);
+	const Hit hit{Shape::bounds(circ), circ, dmg, true};
 	switch (a->getTarget()) {
 	case AttackTarget::NONE:
-		return false;
+		break;
 	case AttackTarget::PLAYER:
-		if (cm->intersectsPlayer(circ)) {
-			damage(*cm->getPlayer(), dmg);
-			return true;
-		}
-		else {
-			return false;
-		}
+		playerHits.push_back(hit);
+		break;
 	case AttackTarget::CREATURES:
-		return procCircCreatures(circ, dmg);
+		creatureHits.push_back(hit);
+		break;
 	}
-	return false;
 }
 
 
@@ -95,30 +133,91 @@ void AttackManager::setCreatureManager(CreatureManager* c) {
 }
 
 
-bool AttackManager::procRectCreatures(const SDL_Rect& rect, const int dmg) {
-	auto creatures = cm->getRect(rect);
-	for (auto c : creatures)
-		damage(*c, dmg);
-	return !creatures.empty();
+template<typename T>
+bool AttackManager::releaseFrom(ObjectPool<T>& pool, Attack* a) {
+	// attacks of pooled types are only created by newRect() and newSpellBasic()
+	T* obj = dynamic_cast<T*>(a);
+	if (obj == nullptr)
+		return false;
+	pool.destroy(obj);
+	return true;
 }
 
 
-bool AttackManager::procCircCreatures(const Circle& circ, const int dmg) {
-	bool ret = false;
-	auto creatures = cm->getRect(Shape::bounds(circ));
-	auto it = creatures.begin();
-	while (it != creatures.end() && !ret) {
-		if (Shape::intersects((**it).getBounds(), circ)) {
-			damage(**it, dmg);
-			ret = true;
-		}
-		++it;
+void AttackManager::resolveHits() {
+	for (const Hit& hit : playerHits) {
+		if (intersects(hit, cm->getPlayer()->getBounds()))
+			damage(*cm->getPlayer(), hit.damage);
 	}
-	while (it != creatures.end()) {
-		if (Shape::intersects((**it).getBounds(), circ)) {
-			damage(**it, dmg);
+	playerHits.clear();
+	if (!creatureHits.empty()) {
+		findTargets();
+		if (!targets.empty())
+			sweep();
+	}
+	creatureHits.clear();
+}
+
+
+// Get creatures in the grid cells of each hit, with their current bounds, sorted
+//   along x
+void AttackManager::findTargets() {
+	found.clear();
+	for (const Hit& hit : creatureHits)
+		cm->getRect(hit.bounds, found);
+	// creatures near several hits are found once for each
+	std::sort(found.begin(), found.end(), std::less<Creature*>());
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+	targets.clear();
+	for (Creature* c : found)
+		targets.push_back(Target{c, c->getBounds()});
+	std::sort(targets.begin(), targets.end(), [](const Target& a, const Target& b) {
+		return (a.bounds.x < b.bounds.x);
+	});
+}
+
+
+// Sort and sweep along x: hits and targets are visited in order of their left
+//   edge, each is tested against the ones of the other kind still open (right
+//   edge not passed yet), so every pair overlapping along x is tested once.
+void AttackManager::sweep() {
+	std::sort(creatureHits.begin(), creatureHits.end(), [](const Hit& a, const Hit& b) {
+		return (a.bounds.x < b.bounds.x);
+	});
+	activeHits.clear();
+	activeTargets.clear();
+	std::size_t h = 0;
+	std::size_t t = 0;
+	// once targets run out, hits left can only reach the open targets
+	while ((h < creatureHits.size()) && ((t < targets.size()) || !activeTargets.empty())) {
+		if ((t == targets.size()) || (creatureHits[h].bounds.x <= targets[t].bounds.x)) {
+			const Hit& hit = creatureHits[h];
+			SweepHelper::removeClosed(activeTargets, hit.bounds.x, [this](const std::size_t i) {
+				return targets[i].bounds;
+			});
+			for (const std::size_t i : activeTargets) {
+				if (intersects(hit, targets[i].bounds))
+					damage(*targets[i].creature, hit.damage);
+			}
+			activeHits.push_back(h++);
+		}
+		else {
+			const Target& target = targets[t];
+			SweepHelper::removeClosed(activeHits, target.bounds.x, [this](const std::size_t i) {
+				return creatureHits[i].bounds;
+			});
+			for (const std::size_t i : activeHits) {
+				if (intersects(creatureHits[i], target.bounds))
+					damage(*target.creature, creatureHits[i].damage);
+			}
+			activeTargets.push_back(t++);
 		}
-		++it;
 	}
-	return ret;
+}
+
+
+bool AttackManager::intersects(const Hit& hit, const SDL_Rect& rect) {
+	if (hit.isCircle)
+		return Shape::intersects(rect, hit.circ);
+	return Shape::intersects(hit.bounds, rect);
 }
@@ -1,32 +1,72 @@
 #pragma once
 
+#include "attack_rect.h"
 #include "constants.h"
+#include "object_pool.h"
 #include "sdl_header.h"
-#include <list>
+#include "shapes.h"	// Circle
+#include "spell_basic.h"
+#include <vector>
 
 
 class Attack;
 class Canvas;
-class Circle;
+class Creature;
 class CreatureManager;
+class Image;
 
 
+// Attacks are created from pools of each type, so attacking doesn't allocate once
+//   the pools have grown. Created attacks are only updated after add(),
+//   attacks that are never added must be given back with release().
+// Hits (procRect(), procCirc()) are resolved together after all attacks have
+//   updated, with a sort and sweep along x. The creatures swept are the ones
+//   CreatureManager's grid finds near the hits, so creatures far from every
+//   attack cost nothing.
 class AttackManager {
 	AttackManager(const AttackManager&) = delete;
 	void operator=(const AttackManager&) = delete;
+
+	struct Hit {
+		SDL_Rect bounds;
+		Circle circ;	// if isCircle, else the shape is bounds
+		int damage;
+		bool isCircle;
+	};
+
+	struct Target {
+		Creature* creature;
+		SDL_Rect bounds;
+	};
 public:
 	AttackManager() = default;
 	~AttackManager();
 	void update(const Constants::float_type);
 	void draw(Canvas&);
+	AttackRect* newRect(void);
+	SpellBasic* newSpellBasic(Image*);
 	void add(Attack*);
-	bool procRect(const Attack*, const SDL_Rect&, const int);
-	bool procCirc(const Attack*, const Circle&, const int);
+	void release(Attack*);
+	void procRect(const Attack*, const SDL_Rect&, const int);
+	void procCirc(const Attack*, const Circle&, const int);
 	void setCreatureManager(CreatureManager*);
 private:
-	bool procRectCreatures(const SDL_Rect&, const int);
-	bool procCircCreatures(const Circle&, const int);
+	void resolveHits(void);
+	void findTargets(void);
+	void sweep(void);
+	static bool intersects(const Hit&, const SDL_Rect&);
+
+	template<typename T>
+	bool releaseFrom(ObjectPool<T>&, Attack*);
 
-	std::list<Attack*> list;
+	ObjectPool<AttackRect> rects;
+	ObjectPool<SpellBasic> spellsBasic;
+	std::vector<Attack*> list;	// added attacks, unordered
+	std::vector<Hit> playerHits;
+	std::vector<Hit> creatureHits;
+	std::vector<Target> targets;	// creatures near hits, sorted by bounds.x
+	std::vector<Creature*> found;	// used by findTargets()
+	std::vector<std::size_t> activeHits;	// used by sweep()
+	std::vector<std::size_t> activeTargets;
 	CreatureManager* cm = nullptr;
 };
@@ -6,6 +6,11 @@
 #include "sprite.h"
 
 
+CanvasLayer::~CanvasLayer() {
+	SDL::freeNull(tex);
+}
+
+
 Canvas::Canvas() {
 	setColor(color, alpha);
 	SDL_Rect windowRect;
@@ -21,7 +26,10 @@ void Canvas::draw(Drawable& d) {
 	dst.y = d.getDrawPosY() + offsetY;
 	dst.w = d.getDrawWidth();
 	dst.h = d.getDrawHeight();
-	SDL_RenderCopy(SDL::renderer, d.getTexture(), d.getTextureBounds(), &dst);
+	if (batching)
+		queueQuad(d.getTexture(), d.getTextureBounds(), dst);
+	else
+		SDL_RenderCopy(SDL::renderer, d.getTexture(), d.getTextureBounds(), &dst);
 }
 
 
@@ -30,7 +38,10 @@ void Canvas::draw(Drawable& d, const int x, const int y) {
 	dst.y = y + offsetY;
 	dst.w = d.getDrawWidth();
 	dst.h = d.getDrawHeight();
-	SDL_RenderCopy(SDL::renderer, d.getTexture(), d.getTextureBounds(), &dst);
+	if (batching)
+		queueQuad(d.getTexture(), d.getTextureBounds(), dst);
+	else
+		SDL_RenderCopy(SDL::renderer, d.getTexture(), d.getTextureBounds(), &dst);
 }
 
 
@@ -39,11 +50,16 @@ void Canvas::draw(Image& img, const int x, const int y) {
 	dst.y = y + offsetY;
 	dst.w = img.getDrawWidth();
 	dst.h = img.getDrawHeight();
-	SDL_RenderCopy(SDL::renderer, img.getTexture(), nullptr, &dst);
+	if (batching)
+		queueQuad(img.getTexture(), nullptr, dst);
+	else
+		SDL_RenderCopy(SDL::renderer, img.getTexture(), nullptr, &dst);
 }
 
 
+// not batched, text images are often destroyed right after being drawn
 void Canvas::draw(const TextImage& img, const int x, const int y) {
+	flush();
 	dst.x = x + offsetX;
 	dst.y = y + offsetY;
 	dst.w = img.getWidth();
@@ -76,7 +92,13 @@ void Canvas::draw(const SDL_Rect& rect, const int sz) {
 	fillRects[3].y = fillRects[2].y;
 	fillRects[3].w = fillRects[2].w;
 	fillRects[3].h = fillRects[2].h;
-	SDL_RenderFillRects(SDL::renderer, fillRects, 4);
+	if (batching) {
+		for (const SDL_Rect& r : fillRects)
+			queueRect(r);
+	}
+	else {
+		SDL_RenderFillRects(SDL::renderer, fillRects, 4);
+	}
 }
 
 
@@ -87,6 +109,7 @@ void Canvas::setRelViewport(const SDL_Rect& rect) {
 	nrect.y = stViewports.top().y + rect.y;
 	nrect.w = rect.w;
 	nrect.h = rect.h;
+	flush();
 	stViewports.push(nrect);
 	SDL::renderSetViewport(&stViewports.top());
 }
@@ -94,6 +117,7 @@ void Canvas::setRelViewport(const SDL_Rect& rect) {
 
 SDL_Texture* Canvas::newRenderTarget() {
 	assert(SDL::targetTextureSupport);
+	flush();
 	SDL_Texture* tex = SDL_CreateTexture(
 		SDL::renderer, SDL_GetWindowPixelFormat(SDL::window), SDL_TEXTUREACCESS_TARGET,
 		Constants::windowWidth, Constants::windowHeight
@@ -114,8 +138,108 @@ SDL_Texture* Canvas::newRenderTarget() {
 
 
 void Canvas::clearRenderTarget() {
+	flush();
 	if (SDL_SetRenderTarget(SDL::renderer, nullptr) != 0) {
 		SDL::logError("Canvas::clearRenderTarget SDL_SetRenderTarget");
 		// throw runtime_error?
 	}
 }
+
+
+// Make the layer texture the render target, false if render targets can't be used
+bool Canvas::beginLayer(CanvasLayer& layer) {
+	if (!SDL::targetTextureSupport)
+		return false;
+	// may be drawn while rendering to another texture
+	layerTarget = SDL_GetRenderTarget(SDL::renderer);
+	if (layer.tex == nullptr) {
+		layer.tex = newRenderTarget();
+		if (layer.tex == nullptr)
+			return false;
+		// opaque, copying is enough
+		SDL_SetTextureBlendMode(layer.tex, SDL_BLENDMODE_NONE);
+		return true;
+	}
+	flush();
+	if (SDL_SetRenderTarget(SDL::renderer, layer.tex) != 0) {
+		SDL::logError("Canvas::beginLayer SDL_SetRenderTarget");
+		return false;
+	}
+	return true;
+}
+
+
+void Canvas::endLayer(CanvasLayer& layer) {
+	flush();
+	if (SDL_SetRenderTarget(SDL::renderer, layerTarget) != 0)
+		SDL::logError("Canvas::endLayer SDL_SetRenderTarget");
+	layerTarget = nullptr;
+	// changing target resets the viewport
+	SDL::renderSetViewport(&stViewports.top());
+	layer.valid = true;
+}
+
+
+// Draw the queued quads
+void Canvas::flush() {
+	if (indices.empty())
+		return;
+	if (SDL_RenderGeometry(SDL::renderer, batchTex, vertices.data(), static_cast<int>(vertices.size()),
+	                       indices.data(), static_cast<int>(indices.size())) != 0) {
+		SDL::logError("Canvas::flush SDL_RenderGeometry");
+	}
+	vertices.clear();
+	indices.clear();
+	// a new texture may get the address of one destroyed after this
+	batchTex = nullptr;
+}
+
+
+// Queue texture (src part of it, all if nullptr) drawn to dest.
+// SDL_RenderGeometry ignores texture color and alpha mod, so they are given as
+//   vertex color.
+void Canvas::queueQuad(SDL_Texture* tex, const SDL_Rect* src, const SDL_Rect& dest) {
+	assert(tex != nullptr);
+	if (tex != batchTex) {
+		flush();
+		batchTex = tex;
+		SDL_QueryTexture(tex, nullptr, nullptr, &batchTexW, &batchTexH);
+	}
+	SDL_Color c;
+	SDL_GetTextureColorMod(tex, &c.r, &c.g, &c.b);
+	SDL_GetTextureAlphaMod(tex, &c.a);
+	const float w = static_cast<float>(batchTexW);
+	const float h = static_cast<float>(batchTexH);
+	if (src == nullptr)
+		queueVertices(dest, c, 0, 0, 1, 1);
+	else
+		queueVertices(dest, c, src->x / w, src->y / h, (src->x + src->w) / w, (src->y + src->h) / h);
+}
+
+
+// Queue rect filled with the current color
+void Canvas::queueRect(const SDL_Rect& dest) {
+	if (batchTex != nullptr) {
+		flush();
+		batchTex = nullptr;
+	}
+	queueVertices(dest, SDL_Color{color.R, color.G, color.B, alpha}, 0, 0, 0, 0);
+}
+
+
+// Two triangles covering dest, with texture coordinates (u0, v0) to (u1, v1)
+void Canvas::queueVertices(const SDL_Rect& dest, const SDL_Color& c, const float u0, const float v0,
+                           const float u1, const float v1) {
+	const int first = static_cast<int>(vertices.size());
+	const float x0 = static_cast<float>(dest.x);
+	const float y0 = static_cast<float>(dest.y);
+	const float x1 = static_cast<float>(dest.x + dest.w);
+	const float y1 = static_cast<float>(dest.y + dest.h);
+	vertices.push_back(SDL_Vertex{SDL_FPoint{x0, y0}, c, SDL_FPoint{u0, v0}});
+	vertices.push_back(SDL_Vertex{SDL_FPoint{x1, y0}, c, SDL_FPoint{u1, v0}});
+	vertices.push_back(SDL_Vertex{SDL_FPoint{x1, y1}, c, SDL_FPoint{u1, v1}});
+	vertices.push_back(SDL_Vertex{SDL_FPoint{x0, y1}, c, SDL_FPoint{u0, v1}});
+	static constexpr int quad[] = {0, 1, 2, 0, 2, 3};
+	for (const int i : quad)
+		indices.push_back(first + i);
+}
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "color.h"
+#include "constants.h"
 #include "exception.h"
+#include "profiler.h"
+#include "trace.h"
 #include "sdl_helper.h"
 #include <cassert>
 #include <stack>
 #include <utility>
+#include <vector>
 
 
+class Canvas;
 class Drawable;
 class Image;
 class TextImage;
@@ -22,6 +27,31 @@ constexpr Uint8 getAlpha() {
 }
 
 
+// Cached drawing of things that rarely change, see Canvas::drawLayer().
+// Owner calls invalidate() when the contents change.
+class CanvasLayer {
+	friend Canvas;
+	CanvasLayer(const CanvasLayer&) = delete;
+	void operator=(const CanvasLayer&) = delete;
+public:
+	CanvasLayer() = default;
+	~CanvasLayer();
+	void invalidate(void);
+	bool isValid(void) const;
+private:
+	SDL_Texture* tex = nullptr;	// created when first drawn
+	bool valid = false;
+};
+
+
+// Drawing is done through the renderer directly, unless batching is enabled.
+// While batching, textured quads and filled rects are gathered into a vertex array
+//   and drawn with one SDL_RenderGeometry call per run of the same texture. The
+//   batch is flushed when the texture changes, before drawing anything that isn't
+//   batched (text, outlines), when render state changes (viewport, clip, render
+//   target) and on present().
+// Only quads still queued keep their texture, nothing about it is kept after a
+//   flush, so a texture drawn this frame can be destroyed once flush() is called.
 class Canvas {
 public:
 	typedef std::pair<Color, Uint8> ColorState;
@@ -39,6 +69,7 @@ public:
 	void draw(Image&, const int, const int);
 	void draw(const TextImage&, const int, const int);
 	void draw(SDL_Texture*, SDL_Rect*);
+	void draw(SDL_Texture*, const SDL_Rect&, const SDL_Rect&);	// part of texture to dest
 	void draw(const SDL_Rect&);
 	void draw(const SDL_Rect&, const int);
 	void fillRect(const SDL_Rect&);
@@ -49,20 +80,45 @@ public:
 	void setClip(SDL_Rect*);
 	SDL_Texture* newRenderTarget(void);
 	void clearRenderTarget(void);
+	template<typename F>
+	void drawLayer(CanvasLayer&, F);
+	template<typename F>
+	SDL_Texture* renderToTexture(F);
 	// Offsets applied to all drawing
 	// Used because negative viewport origin does not work
 	void setOffset(const int, const int);
 	void clearOffset(void);
 	void setColorState(const ColorState&);
 	ColorState getColorState(void) const;
+	// How far between the previous and current update the frame being drawn is.
+	// Used to interpolate positions of moving entities.
+	void setInterpolation(const Constants::float_type);
+	Constants::float_type getInterpolation(void) const;
+	void setBatching(const bool);
+	bool getBatching(void) const;
+	void flush(void);
 private:
+	bool beginLayer(CanvasLayer&);
+	void endLayer(CanvasLayer&);
+	void queueQuad(SDL_Texture*, const SDL_Rect*, const SDL_Rect&);
+	void queueRect(const SDL_Rect&);
+	void queueVertices(const SDL_Rect&, const SDL_Color&, const float, const float, const float, const float);
+
 	std::stack<std::pair<int, int>> stOffsets;
 	std::stack<SDL_Rect> stViewports;
 	SDL_Rect dst;	// used by various functions
 	int offsetX = 0;
 	int offsetY = 0;
 	Color color;
+	Constants::float_type interp = 1;
 	Uint8 alpha = SDL_ALPHA_OPAQUE;
+	std::vector<SDL_Vertex> vertices;	// batch, 4 per quad
+	std::vector<int> indices;	// 6 per quad
+	SDL_Texture* batchTex = nullptr;	// nullptr for filled rects
+	int batchTexW = 0;
+	int batchTexH = 0;
+	SDL_Texture* layerTarget = nullptr;	// render target to restore after drawing a layer
+	bool batching = false;
 };
 
 
@@ -103,12 +159,16 @@ void Canvas::setAlpha(const Uint8 a) {
 inline
 void Canvas::clearScreen() {
 	// Note: this ignores viewport
+	flush();
 	SDL_RenderClear(SDL::renderer);
 }
 
 
 inline
 void Canvas::present() {
+	ProfileScope ps{Profiler::Zone::PRESENT};
+	TraceScope ts{"present"};
+	flush();
 	SDL_RenderPresent(SDL::renderer);
 }
 
@@ -120,7 +180,10 @@ void Canvas::fillRect(const SDL_Rect& r) {
 	dst.y = r.y + offsetY;
 	dst.w = r.w;
 	dst.h = r.h;
-	SDL_RenderFillRect(SDL::renderer, &dst);
+	if (batching)
+		queueRect(dst);
+	else
+		SDL_RenderFillRect(SDL::renderer, &dst);
 }
 
 
@@ -130,7 +193,10 @@ void Canvas::fillRect(const int x, const int y, const int w, const int h) {
 	dst.y = y + offsetY;
 	dst.w = w;
 	dst.h = h;
-	SDL_RenderFillRect(SDL::renderer, &dst);
+	if (batching)
+		queueRect(dst);
+	else
+		SDL_RenderFillRect(SDL::renderer, &dst);
 }
 
 
@@ -140,12 +206,33 @@ void Canvas::draw(SDL_Texture* tex, SDL_Rect* dest) {
 	dst.y = dest->y + offsetY;
 	dst.w = dest->w;
 	dst.h = dest->h;
-	SDL_RenderCopy(SDL::renderer, tex, nullptr, &dst);
+	if (batching)
+		queueQuad(tex, nullptr, dst);
+	else
+		SDL_RenderCopy(SDL::renderer, tex, nullptr, &dst);
+}
+
+
+inline
+void Canvas::draw(SDL_Texture* tex, const SDL_Rect& src, const SDL_Rect& dest) {
+	dst.x = dest.x + offsetX;
+	dst.y = dest.y + offsetY;
+	dst.w = dest.w;
+	dst.h = dest.h;
+	if (batching)
+		queueQuad(tex, &src, dst);
+	else
+		SDL_RenderCopy(SDL::renderer, tex, &src, &dst);
 }
 
 
 inline
 void Canvas::draw(const SDL_Rect& rect) {
+	if (batching) {
+		// same pixels as SDL_RenderDrawRect
+		draw(rect, 1);
+		return;
+	}
 	dst.x = rect.x + offsetX;
 	dst.y = rect.y + offsetY;
 	dst.w = rect.w;
@@ -157,6 +244,7 @@ void Canvas::draw(const SDL_Rect& rect) {
 // reassigns screen to rect
 inline
 void Canvas::setViewport(const SDL_Rect& rect) {
+	flush();
 	stViewports.push(rect);
 	SDL::renderSetViewport(&stViewports.top());
 }
@@ -165,6 +253,7 @@ void Canvas::setViewport(const SDL_Rect& rect) {
 inline
 void Canvas::clearViewport() {
 	assert(!stViewports.empty());
+	flush();
 	stViewports.pop();
 	SDL::renderSetViewport(&stViewports.top());
 }
@@ -173,6 +262,7 @@ void Canvas::clearViewport() {
 // draw only inside clip
 inline
 void Canvas::setClip(SDL_Rect* rect) {
+	flush();
 	SDL::renderSetClipRect(rect);
 }
 
@@ -204,3 +294,84 @@ inline
 Canvas::ColorState Canvas::getColorState() const {
 	return std::make_pair(color, alpha);
 }
+
+
+inline
+void Canvas::setInterpolation(const Constants::float_type a) {
+	assert((a >= 0) && (a <= 1));
+	interp = a;
+}
+
+
+inline
+Constants::float_type Canvas::getInterpolation() const {
+	return interp;
+}
+
+
+inline
+void Canvas::setBatching(const bool b) {
+	flush();
+	batching = b;
+}
+
+
+inline
+bool Canvas::getBatching() const {
+	return batching;
+}
+
+
+// Draw layer, first calling render(Canvas&) to draw its contents into the layer
+//   texture if it was invalidated.
+// Layers cover the window and are opaque, so they replace anything drawn before
+//   them. Call with no viewport or offset set.
+// Without target texture support, render is called every time.
+template<typename F>
+void Canvas::drawLayer(CanvasLayer& layer, F render) {
+	if (!layer.valid) {
+		if (!beginLayer(layer)) {
+			render(*this);
+			return;
+		}
+		render(*this);
+		endLayer(layer);
+	}
+	dst = stViewports.top();
+	dst.x = 0;
+	dst.y = 0;
+	if (batching)
+		queueQuad(layer.tex, nullptr, dst);
+	else
+		SDL_RenderCopy(SDL::renderer, layer.tex, nullptr, &dst);
+}
+
+
+// Draw with render(Canvas&) into a new window sized texture, without reading
+//   anything back from the renderer. Caller owns the texture.
+// Returns nullptr without target texture support.
+template<typename F>
+SDL_Texture* Canvas::renderToTexture(F render) {
+	if (!SDL::targetTextureSupport)
+		return nullptr;
+	SDL_Texture* tex = newRenderTarget();
+	if (tex == nullptr)
+		return nullptr;
+	render(*this);
+	clearRenderTarget();
+	// changing target resets the viewport
+	SDL::renderSetViewport(&stViewports.top());
+	return tex;
+}
+
+
+inline
+void CanvasLayer::invalidate() {
+	valid = false;
+}
+
+
+inline
+bool CanvasLayer::isValid() const {
+	return valid;
+}
@@ -20,6 +20,15 @@ namespace Constants {
 	constexpr std::size_t maxIndex = std::numeric_limits<std::size_t>::max();
 	// Console
 	constexpr bool ConsoleMilliseconds = true;
+	// CreatureManager
+	constexpr int CMGridCellSz = 32;	// side of creature grid cells
+	constexpr unsigned int CMMaxWorkers = 8;	// threads updating creatures, including main
+	constexpr int CMFlowCellSz = 16;	// side of pathfinding cells
+	// default creature AI scheduling, see CreatureManager::ThinkPolicy
+	constexpr unsigned int CMThinkBuckets = 6;	// ticks between thinks near player
+	constexpr unsigned int CMThinkFarMult = 4;	// far creatures think this many times less often
+	constexpr int CMThinkFarDist = 192;	// pixels from player center
+	constexpr unsigned int CMThinkBudget = 2048;	// most thinks per tick
 	// JSONReader
 	constexpr std::size_t JSONBufferSz = (8 * 1024);
 	// Map
@@ -40,7 +49,11 @@ namespace Constants {
 	// Room
 	constexpr int RoomX = 0;	// offset
 	constexpr int RoomY = 18;	// offset
+	enum class RoomBlockType {QUADTREE, BITMAP, SAT};	// collision backend
+	constexpr RoomBlockType RoomBlock = RoomBlockType::SAT;
 	constexpr std::size_t RoomQTreeNodeCap = 8;
+	constexpr int RoomQTreeMinSz = 16;	// smallest quad side
+	constexpr int RoomSweepCellSz = 64;	// side of the grid cells block rects are found by when sweeping
 	// SpellManager
 	constexpr float SMTravelSpeed = 500.0f;	// pixels per second spell travel
 	constexpr float SMFadeDur = 0.130;		// fadeout duration
@@ -17,8 +17,12 @@ public:
 	virtual void spawn(CreatureManager*, const int, const int) = 0;
 	void damage(const int) override;
 	HealthBar*& getHealthBar(void);
+	bool isHealthBarPooled(void) const;
+	void setHealthBarPooled(const bool);	// by CreatureManager when it gives the health bar
 protected:
 	HealthBar* healthBar = nullptr;
+private:
+	bool healthBarPooled = false;
 };
 
 
@@ -44,3 +48,15 @@ inline
 HealthBar*& Creature::getHealthBar() {
 	return healthBar;
 }
+
+
+inline
+bool Creature::isHealthBarPooled() const {
+	return healthBarPooled;
+}
+
+
+inline
+void Creature::setHealthBarPooled(const bool pooled) {
+	healthBarPooled = pooled;
+}
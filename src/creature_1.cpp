@@ -1,12 +1,9 @@
 #include "creature_1.h"
-#include "attack_manager.h"
-#include "attack_rect.h"
 #include "canvas.h"
 #include "creature_manager.h"
 #include "game_data.h"
 #include "main_game_objects.h"
 #include "resource_manager.h"
-#include "room.h"
 #include <cmath>
 #include <cassert>
 
@@ -16,7 +13,6 @@ namespace Creature1Settings {
 	// Minimum square distance from self to target to initiate attack.
 	constexpr float minDistAttack2 = 7 * 7;
 	constexpr float speed = 50;	// pixels per second, includes both axes
-	constexpr Constants::float_type refreshTargetDirection = 0.1;
 	constexpr int attackWidth = 10;
 	constexpr int attackHeight = 20;
 }
@@ -41,6 +37,7 @@ void Creature1::spawn(CreatureManager* cm, const int x, const int y) {
 	target = cm->getTarget();
 	entityPos.x = x;
 	entityPos.y = y;
+	savePrevPos();
 
 	state = CreatureState::MOVING;
 	updateTargetPos();
@@ -49,7 +46,7 @@ void Creature1::spawn(CreatureManager* cm, const int x, const int y) {
 
 bool Creature1::update(const Constants::float_type dt) {
 	using namespace Creature1Settings;
-	time -= dt;
+	savePrevPos();
 	switch (state) {
 	case CreatureState::NONE:
 		break;
@@ -70,7 +67,8 @@ bool Creature1::update(const Constants::float_type dt) {
 
 
 void Creature1::draw(Canvas& can) {
-	can.draw(*curSpr, static_cast<int>(entityPos.x), static_cast<int>(entityPos.y));
+	const Vector2D<> drawPos = getDrawPos(can.getInterpolation());
+	can.draw(*curSpr, static_cast<int>(drawPos.x), static_cast<int>(drawPos.y));
 #ifndef NDEBUG
 	if (state == CreatureState::ATTACKING) {
 		auto oldColor = can.getColorState();
@@ -123,7 +121,13 @@ void Creature1::updateTargetPos() {
 		curSpr = &sprMovL;
 		targetX = tRect.x + tRect.w;
 	}
-	// update velocity
+	// update velocity, follow path to target until close
+	const SDL_Rect bounds = getBounds();
+	const FlowField& flow = GameData::instance().mgo->getCreatureManager().getFlowField();
+	if (flow.getDir(bounds.x + (bounds.w / 2), bounds.y + (bounds.h / 2), vel)) {
+		vel *= speed;
+		return;
+	}
 	vel.x = (targetX - entityPos.x);
 	vel.y = (tRect.y - entityPos.y);
 	vel *= (speed / vel.length());
@@ -132,7 +136,7 @@ void Creature1::updateTargetPos() {
 
 void Creature1::updatePosition(const Constants::float_type dt) {
 	curSpr->update(dt);
-	GameData::instance().mgo->getRoom().update(*this, vel * dt);
+	GameData::instance().mgo->getCreatureManager().move(*this, vel * dt);
 }
 
 
@@ -157,18 +161,11 @@ void Creature1::movingUpdate(const Constants::float_type dt) {
 			attackRect.y = static_cast<int>(entityPos.y);
 		}
 
-		AttackRect* ar = new AttackRect;
-		ar->setSource(this);
-		ar->setTarget(AttackTarget::PLAYER);
-		ar->setRect(attackRect);
-		ar->setDamage(1);
-		GameData::instance().mgo->getAttackManager().add(ar);
+		GameData::instance().mgo->getCreatureManager().addAttack(this, attackRect, 1);
 	}
 	else {
 		updatePosition(dt);
-		if (time <= 0) {
-			time = refreshTargetDirection;
+		if (think.now)
 			updateTargetPos();
-		}
 	}
 }
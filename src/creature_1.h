@@ -10,15 +10,24 @@
 Behavior: Always moving toward target when not in attack range.
 When attacking: freeze position for some time, begin attack animation, then attack.
 */
-class Creature1 : public Creature {
+class Creature1 final : public Creature {
 	enum class CreatureState {NONE, MOVING, ATTACKING, KNOCKBACK};
 public:
+	// when to pick a new direction, set by CreatureManager
+	struct Think {
+		unsigned int slot = 0;	// round-robin position
+		bool due = false;	// waiting for budget
+		bool now = false;	// think this update
+	};
+
 	Creature1();
 	~Creature1();
 	void spawn(CreatureManager*, const int, const int) override;
 	bool update(const Constants::float_type) override;
 	void draw(Canvas&) override;
 	SDL_Rect getBounds(void) const override;
+	Think& getThink(void);
+	bool isMoving(void) const;
 private:
 	bool shouldAttack(void);
 	void updateTargetPos(void);
@@ -33,6 +42,18 @@ private:
 	AnimatedSprite* curSpr = nullptr;
 	KillableGameEntity* target = nullptr;
 	CreatureState state = CreatureState::NONE;
+	Think think;
 	int attackTicks = 0;
-	Constants::float_type time = 0;
 };
+
+
+inline
+Creature1::Think& Creature1::getThink() {
+	return think;
+}
+
+
+inline
+bool Creature1::isMoving() const {
+	return (state == CreatureState::MOVING);
+}
@@ -11,12 +11,14 @@ void Creature1Sp::spawn(CreatureManager* man, const int x, const int y) {
 	cm = man;
 	entityPos.x = x;
 	entityPos.y = y;
+	savePrevPos();
 	sp = cm->getSprite("cr1sp");
+	startSpawnTimer();
 }
 
 
-bool Creature1Sp::update(const Constants::float_type dt) {
-	updateTick(dt);
+// spawning is done by the timer
+bool Creature1Sp::update(const Constants::float_type) {
 	return false;
 }
 
@@ -5,7 +5,7 @@
 #include "sprite.h"
 
 
-class Creature1Sp : public CreatureSpawner {
+class Creature1Sp final : public CreatureSpawner {
 public:
 	Creature1Sp();
 	~Creature1Sp() = default;
@@ -0,0 +1,107 @@
+#include "creature_grid.h"
+#include "constants.h"
+#include "creature.h"
+#include <algorithm>	// find_if, max, min
+#include <cassert>
+
+
+CreatureGrid::CreatureGrid() :
+	countX((Constants::roomWidth / Constants::CMGridCellSz) + 1),
+	countY((Constants::roomHeight / Constants::CMGridCellSz) + 1)
+{
+	cells.resize(static_cast<std::size_t>(countX * countY));
+}
+
+
+void CreatureGrid::insert(Creature* c) {
+	assert(ranges.count(c) == 0);
+	const Entry e{c, toRange(c->getBounds())};
+	ranges.emplace(c, e.range);
+	addTo(e);
+}
+
+
+void CreatureGrid::remove(Creature* c) {
+	auto it = ranges.find(c);
+	assert(it != ranges.end());
+	removeFrom(Entry{c, it->second});
+	ranges.erase(it);
+}
+
+
+// Move creature to the cells of its current bounds, if they changed
+void CreatureGrid::update(Creature* c) {
+	auto it = ranges.find(c);
+	assert(it != ranges.end());
+	const CellRange range = toRange(c->getBounds());
+	if (range == it->second)
+		return;
+	removeFrom(Entry{c, it->second});
+	it->second = range;
+	addTo(Entry{c, range});
+}
+
+
+// Add creatures that may intersect rect to found, each only once
+void CreatureGrid::query(const SDL_Rect& rect, std::vector<Creature*>& found) const {
+	if ((rect.w <= 0) || (rect.h <= 0))
+		return;
+	const CellRange q = toRange(rect);
+	for (int y = q.y0; y <= q.y1; ++y) {
+		for (int x = q.x0; x <= q.x1; ++x) {
+			for (const Entry& e : cell(x, y)) {
+				// a creature in several cells is only added in the first cell
+				//   of the query it is in
+				if ((x == std::max(e.range.x0, q.x0)) && (y == std::max(e.range.y0, q.y0)))
+					found.push_back(e.creature);
+			}
+		}
+	}
+}
+
+
+void CreatureGrid::clear() {
+	for (auto& c : cells)
+		c.clear();
+	ranges.clear();
+}
+
+
+CreatureGrid::CellRange CreatureGrid::toRange(const SDL_Rect& r) const {
+	// anything left of or above the room is in cell 0
+	auto toCell = [](const int pos, const int count) {
+		return std::min(std::max(pos / Constants::CMGridCellSz, 0), count - 1);
+	};
+	const int x = r.x - Constants::RoomX;
+	const int y = r.y - Constants::RoomY;
+	return CellRange{
+		toCell(x, countX),
+		toCell(y, countY),
+		toCell(x + std::max(r.w, 1) - 1, countX),
+		toCell(y + std::max(r.h, 1) - 1, countY)
+	};
+}
+
+
+void CreatureGrid::addTo(const Entry& e) {
+	for (int y = e.range.y0; y <= e.range.y1; ++y) {
+		for (int x = e.range.x0; x <= e.range.x1; ++x)
+			cell(x, y).push_back(e);
+	}
+}
+
+
+// order of creatures in a cell doesn't matter, so swap with last
+void CreatureGrid::removeFrom(const Entry& e) {
+	for (int y = e.range.y0; y <= e.range.y1; ++y) {
+		for (int x = e.range.x0; x <= e.range.x1; ++x) {
+			std::vector<Entry>& v = cell(x, y);
+			auto it = std::find_if(v.begin(), v.end(), [&e](const Entry& other) {
+				return (other.creature == e.creature);
+			});
+			assert(it != v.end());
+			*it = v.back();
+			v.pop_back();
+		}
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "sdl_header.h"
+#include <unordered_map>
+#include <vector>
+
+
+class Creature;
+
+
+// Fixed grid of cells over the room, each cell lists the creatures whose bounds
+//   overlap it. Creatures outside of the room are kept in the edge cells.
+// Positions are only read in insert() and update(), so update() must be called
+//   after a creature moves for query() to find it.
+class CreatureGrid {
+	CreatureGrid(const CreatureGrid&) = delete;
+	void operator=(const CreatureGrid&) = delete;
+
+	// inclusive range of cells
+	struct CellRange {
+		bool operator==(const CellRange&) const;
+
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+	};
+
+	struct Entry {
+		Creature* creature;
+		CellRange range;
+	};
+public:
+	CreatureGrid();
+	~CreatureGrid() = default;
+	void insert(Creature*);
+	void remove(Creature*);
+	void update(Creature*);
+	void query(const SDL_Rect&, std::vector<Creature*>&) const;
+	void clear(void);
+private:
+	CellRange toRange(const SDL_Rect&) const;
+	void addTo(const Entry&);
+	void removeFrom(const Entry&);
+	std::vector<Entry>& cell(const int, const int);
+	const std::vector<Entry>& cell(const int, const int) const;
+
+	std::vector<std::vector<Entry>> cells;
+	std::unordered_map<Creature*, CellRange> ranges;	// range each creature was added to
+	int countX;
+	int countY;
+};
+
+
+inline
+bool CreatureGrid::CellRange::operator==(const CellRange& r) const {
+	return ((x0 == r.x0) && (y0 == r.y0) && (x1 == r.x1) && (y1 == r.y1));
+}
+
+
+inline
+std::vector<CreatureGrid::Entry>& CreatureGrid::cell(const int x, const int y) {
+	return cells[static_cast<std::size_t>((y * countX) + x)];
+}
+
+
+inline
+const std::vector<CreatureGrid::Entry>& CreatureGrid::cell(const int x, const int y) const {
+	return cells[static_cast<std::size_t>((y * countX) + x)];
+}
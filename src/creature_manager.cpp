@@ -1,24 +1,32 @@
 #include "creature_manager.h"
+#include "attack_manager.h"
 #include "canvas.h"
 #include "creature.h"
 #include "exception.h"
 #include "game_data.h"
-#include "health_bar_entity.h"
 #include "logger.h"
+#include "main_game_objects.h"
 #include "parameters.h"
 #include "player.h"
 #include "resource_manager.h"
 #include "room.h"
 #include "shapes.h"
+#include "trace.h"
+#include <algorithm>	// max, min
 #ifndef NDEBUG
 #include "constants.h"
 #endif
-// All creatures
-#include "creature_1.h"
-#include "creature_1sp.h"
 
 
-CreatureManager::CreatureManager(Player* p, Room* r) : player(p), room(r) {
+thread_local CreatureManager::Commands* CreatureManager::current = nullptr;
+
+
+CreatureManager::CreatureManager(Player* p, Room* r) :
+	workers(std::max(1u, std::min(std::thread::hardware_concurrency(), Constants::CMMaxWorkers))),
+	thinkPolicy{Constants::CMThinkBuckets, Constants::CMThinkFarMult, Constants::CMThinkFarDist, Constants::CMThinkBudget},
+	player(p),
+	room(r)
+{
 	// populate creature string to type mapping
 	lookupMap.emplace("cr1", CreatureType::T1);
 	lookupMap.emplace("cr1sp", CreatureType::SP1);
@@ -26,39 +34,61 @@ CreatureManager::CreatureManager(Player* p, Room* r) : player(p), room(r) {
 
 
 CreatureManager::~CreatureManager() {
-	for (auto c : creatures)
-		del(c);
+	creatures1.forEach([this](Creature1& c) {
+		del(creatures1, &c);
+	});
+	spawners1.forEach([this](Creature1Sp& c) {
+		del(spawners1, &c);
+	});
 }
 
 
+// Creature1 are updated in parallel, one job per pool chunk. Everything they change
+//   outside of themselves is recorded in the chunk's Commands and applied after, in
+//   chunk order, so the result doesn't depend on the number of threads.
+// Spawners are updated first on this thread, since they use the shared random generator.
 void CreatureManager::update(const Constants::float_type dt) {
-	if (creatures.empty())
+	if (creatures1.empty() && spawners1.empty())
 		notifyEmpty();
-	for (auto it = creatures.begin(); it != creatures.end();) {
-		if (((**it).getHealth() <= 0) || (**it).update(dt)) {
-			del(*it);
-			it = creatures.erase(it);
-		}
-		else {
-			++it;
-		}
-	}
+	flow.update(player->getBounds());
+	for (std::size_t i = 0; i < spawners1.chunkCount(); ++i)
+		updateChunk(spawners1, i, dt, spawnerCommands);
+	const std::size_t chunks = creatures1.chunkCount();
+	// budget is split exactly, the chunks given the remainder rotate every tick
+	const std::size_t chunkBudget = (chunks == 0) ? 0 : (thinkPolicy.budget / chunks);
+	const std::size_t chunkExtra = (chunks == 0) ? 0 : (thinkPolicy.budget % chunks);
+	++thinkTick;
+	creatureCommands.resize(chunks);
+	workers.run(chunks, [this, dt, chunks, chunkBudget, chunkExtra](const std::size_t i) {
+		TraceScope trace{"creatures"};
+		const bool extra = (((i + thinkTick) % chunks) < chunkExtra);
+		scheduleThinks(i, static_cast<unsigned int>(chunkBudget + (extra ? 1 : 0)));
+		updateChunk(creatures1, i, dt, creatureCommands[i]);
+	});
+	apply(spawners1, spawnerCommands);
+	for (Commands& cmds : creatureCommands)
+		apply(creatures1, cmds);
+	room->updateBatch(moves);
+	moves.clear();
+	forEachCreature([this](Creature& c) {
+		grid.update(&c);
+	});
 }
 
 
 void CreatureManager::draw(Canvas& can) {
-	for (auto c : creatures) {
-		c->draw(can);
-		c->getHealthBar()->draw(can);
+	forEachCreature([&can](Creature& c) {
+		c.draw(can);
+		c.getHealthBar()->draw(can);
 #if defined(DEBUG_CREATURE_BOUNDS) && DEBUG_CREATURE_BOUNDS
 		// draw overlay over each creature
-		auto rect = c->getBounds();
+		auto rect = c.getBounds();
 		auto oldColor = can.getColorState();
 		can.setColor(DEBUG_CREATURE_BOUNDS_COLOR, getAlpha<DEBUG_CREATURE_BOUNDS_ALPHA>());
 		can.fillRect(rect);
 		can.setColorState(oldColor);
 #endif // DEBUG_CREATURE_BOUNDS
-	}
+	});
 }
 
 
@@ -76,18 +106,15 @@ bool CreatureManager::spawn(const CreatureType ct, const int x, const int y) {
 	Creature* c = newCreature(ct);
 	c->spawn(this, x, y);
 	//! TODO make sure creature has spawned in valid location (not inside room block)
-	creatures.push_back(c);
+	grid.insert(c);
 	return true;
 }
 
 
-std::vector<Creature*> CreatureManager::getRect(const SDL_Rect& rect) const {
-	std::vector<Creature*> vc;
-	for (auto c : creatures) {
-		if (Shape::intersects(rect, c->getBounds()))
-			vc.push_back(c);
-	}
-	return vc;
+// Add creatures in grid cells covered by rect to found, their bounds may not
+//   intersect rect
+void CreatureManager::getRect(const SDL_Rect& rect, std::vector<Creature*>& found) const {
+	grid.query(rect, found);
 }
 
 
@@ -104,6 +131,7 @@ bool CreatureManager::intersectsPlayer(const Circle& circ) const {
 // room data
 void CreatureManager::setRoom(rapidjson::Document& data) {
 	namespace rj = rapidjson;
+	flow.setRoom(*room);
 	// process loading/unloading creatures
 	// first populate creatures used in room
 	std::vector<CreatureType> dataCrTypes;
@@ -214,11 +242,94 @@ void CreatureManager::notifyEmpty() const {
 }
 
 
-void CreatureManager::del(Creature* c) {
+// Choose the creatures of a chunk of creatures1 that think this update, see ThinkPolicy.
+// Only reads the player, so chunks can be scheduled in parallel.
+void CreatureManager::scheduleThinks(const std::size_t chunk, unsigned int budget) {
+	const SDL_Rect pb = player->getBounds();
+	const int px = pb.x + (pb.w / 2);
+	const int py = pb.y + (pb.h / 2);
+	const int farDist2 = thinkPolicy.farDist * thinkPolicy.farDist;
+	const unsigned int nearPeriod = thinkPolicy.buckets;
+	const unsigned int farPeriod = thinkPolicy.buckets * thinkPolicy.farMult;
+	creatures1.forEachIn(chunk, [&](Creature1& c) {
+		Creature1::Think& think = c.getThink();
+		const SDL_Rect b = c.getBounds();
+		const int dx = b.x + (b.w / 2) - px;
+		const int dy = b.y + (b.h / 2) - py;
+		const unsigned int period = (((dx * dx) + (dy * dy)) > farDist2) ? farPeriod : nearPeriod;
+		if (((thinkTick + think.slot) % period) == 0)
+			think.due = true;
+		// only moving creatures think, others keep waiting
+		think.now = (think.due && c.isMoving() && (budget > 0));
+		if (think.now) {
+			think.due = false;
+			--budget;
+		}
+	});
+}
+
+
+// Update the creatures in a chunk of pool, recording dead ones in cmds
+template<typename T>
+void CreatureManager::updateChunk(ObjectPool<T>& pool, const std::size_t chunk, const Constants::float_type dt, Commands& cmds) {
+	current = &cmds;
+	pool.forEachIn(chunk, [&cmds, dt](T& c) {
+		if ((c.getHealth() <= 0) || c.update(dt)) {
+			// drop the move it queued this tick, if any
+			if (!cmds.moves.empty() && (cmds.moves.back().entity == &c))
+				cmds.moves.pop_back();
+			cmds.dead.push_back(&c);
+		}
+	});
+	current = nullptr;
+}
+
+
+// Apply the commands recorded while updating creatures of pool
+template<typename T>
+void CreatureManager::apply(ObjectPool<T>& pool, Commands& cmds) {
+	moves.insert(moves.end(), cmds.moves.begin(), cmds.moves.end());
+	AttackManager& am = GameData::instance().mgo->getAttackManager();
+	for (const RectAttack& ra : cmds.attacks) {
+		AttackRect* ar = am.newRect();
+		ar->setSource(ra.source);
+		ar->setTarget(AttackTarget::PLAYER);
+		ar->setRect(ra.rect);
+		ar->setDamage(ra.damage);
+		am.add(ar);
+	}
+	for (Creature* c : cmds.dead) {
+		grid.remove(c);
+		del(pool, static_cast<T*>(c));
+	}
+	cmds.moves.clear();
+	cmds.attacks.clear();
+	cmds.dead.clear();
+}
+
+
+CreatureManager::Commands& CreatureManager::commands() {
+	assert(current != nullptr);
+	return *current;
+}
+
+
+template<typename F>
+void CreatureManager::forEachCreature(F f) {
+	spawners1.forEach(f);
+	creatures1.forEach(f);
+}
+
+
+template<typename T>
+void CreatureManager::del(ObjectPool<T>& pool, T* c) {
 	assert(c != nullptr);
 	assert(c->getHealthBar() != nullptr);
-	delete c->getHealthBar();
-	delete c;
+	if (c->isHealthBarPooled())
+		healthBars.destroy(static_cast<EntityHealthBar*>(c->getHealthBar()));
+	else
+		delete c->getHealthBar();	// created by creature
+	pool.destroy(c);
 }
 
 
@@ -226,11 +337,14 @@ Creature* CreatureManager::newCreature(const CreatureType ct) {
 	assert(ct != CreatureType::NONE);
 	Creature* c;
 	switch (ct) {
-	case CreatureType::T1:
-		c = new Creature1;
+	case CreatureType::T1: {
+		Creature1* c1 = creatures1.create();
+		c1->getThink().slot = nextThinkSlot++;	// spread over buckets
+		c = c1;
 		break;
+	}
 	case CreatureType::SP1:
-		c = new Creature1Sp;
+		c = spawners1.create();
 		break;
 	default:
 		assert(false);
@@ -240,8 +354,10 @@ Creature* CreatureManager::newCreature(const CreatureType ct) {
 		Logger::instance().exit(RuntimeError{"CreatureManager::newCreature", "unexpected nullptr"});
 	}
 	else {
-		if (c->getHealthBar() == nullptr)
-			c->getHealthBar() = new EntityHealthBar(c, c->getHealth());
+		if (c->getHealthBar() == nullptr) {
+			c->getHealthBar() = healthBars.create(c, c->getHealth());
+			c->setHealthBarPooled(true);
+		}
 	}
 	return c;
 }
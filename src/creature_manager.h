@@ -1,11 +1,19 @@
 #pragma once
 
 #include "constants.h"
+#include "creature_1.h"
+#include "creature_1sp.h"
+#include "creature_grid.h"
 #include "creature_type.h"
+#include "flow_field.h"
+#include "health_bar_entity.h"
 #include "json_reader.h"
+#include "object_pool.h"
+#include "room.h"	// RoomMove
 #include "sdl_header.h"
 #include "utility.h"	// EnumClassHash
-#include <list>
+#include "worker_pool.h"
+#include <cassert>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -16,9 +24,9 @@
 class Canvas;
 class Circle;
 class Creature;
+class Entity;
 class KillableGameEntity;
 class Player;
-class Room;
 class Sprite;
 
 
@@ -36,7 +44,33 @@ class CreatureManager {
 	typedef std::vector<CreatureResources> ResourceList;
 	typedef std::unordered_set<CreatureType, EnumClassHash> CreatureTypeSet;
 	typedef std::unordered_map<CreatureType, ResourceList, EnumClassHash> CreatureResourceMap;
+
+	// Attack on the player, made into an AttackRect when applied
+	struct RectAttack {
+		Entity* source;
+		SDL_Rect rect;
+		int damage;
+	};
+
+	// Side effects of creature updates, applied after all creatures have updated
+	struct Commands {
+		std::vector<RoomMove> moves;
+		std::vector<RectAttack> attacks;
+		std::vector<Creature*> dead;
+	};
 public:
+	// How often Creature1 think (pick a new direction to the player).
+	// Creatures think in round-robin order, each once per buckets ticks, or
+	//   buckets * farMult ticks if further than farDist from the player.
+	// At most budget creatures think per tick (shared evenly by pool chunks),
+	//   the rest wait for a later tick.
+	struct ThinkPolicy {
+		unsigned int buckets;
+		unsigned int farMult;
+		int farDist;
+		unsigned int budget;
+	};
+
 	CreatureManager(Player*, Room*);
 	~CreatureManager();
 	void update(const Constants::float_type);
@@ -45,25 +79,53 @@ public:
 	Room* getRoom(void);
 	Sprite getSprite(const std::string&);
 	Player* getPlayer(void) const;
+	std::size_t count(void) const;	// creatures of all types
+	const FlowField& getFlowField(void) const;	// paths to player
 	bool spawn(const CreatureType, const int, const int);	// called by Creature
-	std::vector<Creature*> getRect(const SDL_Rect&) const;	// get creatures contained in the rect
+	void move(GameEntity&, const Vector2D<>&);	// called by Creature
+	void addAttack(Entity*, const SDL_Rect&, const int);	// called by Creature
+	void getRect(const SDL_Rect&, std::vector<Creature*>&) const;	// creatures that may be in the rect
 	bool intersectsPlayer(const SDL_Rect&) const;
 	bool intersectsPlayer(const Circle&) const;
 	void setRoom(rapidjson::Document&);
+	void setThinkPolicy(const ThinkPolicy&);
 private:
 	void loadCreature(const CreatureType);
 	void unloadCreature(const CreatureType);
 	void loadAnimations(rapidjson::Document&, ResourceList&);
 	CreatureType getCreatureType(const std::string&);
 	void notifyEmpty(void) const;
-	void del(Creature*);
-	static Creature* newCreature(const CreatureType);
+	void scheduleThinks(const std::size_t, unsigned int);
+	template<typename T>
+	void updateChunk(ObjectPool<T>&, const std::size_t, const Constants::float_type, Commands&);
+	template<typename T>
+	void apply(ObjectPool<T>&, Commands&);
+	static Commands& commands(void);
+	template<typename F>
+	void forEachCreature(F);
+	template<typename T>
+	void del(ObjectPool<T>&, T*);
+	Creature* newCreature(const CreatureType);
 
 	std::unordered_map<std::string, CreatureType> lookupMap;
 	CreatureResourceMap loaded;
-	std::list<Creature*> creatures;
+	// creatures of each type are stored together, so updating them doesn't jump
+	//   around memory or go through virtual calls
+	ObjectPool<Creature1> creatures1;
+	ObjectPool<Creature1Sp> spawners1;
+	ObjectPool<EntityHealthBar> healthBars;
+	CreatureGrid grid;	// for range queries
+	FlowField flow;
+	WorkerPool workers;
+	Commands spawnerCommands;
+	std::vector<Commands> creatureCommands;	// one per chunk of creatures1
+	std::vector<RoomMove> moves;	// done together at the end of update()
+	ThinkPolicy thinkPolicy;
+	unsigned int nextThinkSlot = 0;
+	unsigned int thinkTick = 0;
 	Player* player = nullptr;
 	Room* room = nullptr;
+	static thread_local Commands* current;	// where commands() records, during update
 };
 
 
@@ -77,3 +139,37 @@ inline
 Player* CreatureManager::getPlayer() const {
 	return player;
 }
+
+
+inline
+std::size_t CreatureManager::count() const {
+	return (creatures1.size() + spawners1.size());
+}
+
+
+inline
+void CreatureManager::setThinkPolicy(const ThinkPolicy& p) {
+	assert((p.buckets > 0) && (p.farMult > 0));
+	thinkPolicy = p;
+}
+
+
+inline
+const FlowField& CreatureManager::getFlowField() const {
+	return flow;
+}
+
+
+// Queue a room move, done with the moves of all other creatures
+inline
+void CreatureManager::move(GameEntity& entity, const Vector2D<>& delta) {
+	commands().moves.push_back(RoomMove{&entity, delta});
+}
+
+
+// Queue an attack on the player, added to AttackManager after all creatures have updated
+// (its pools aren't thread safe)
+inline
+void CreatureManager::addAttack(Entity* source, const SDL_Rect& rect, const int damage) {
+	commands().attacks.push_back(RectAttack{source, rect, damage});
+}
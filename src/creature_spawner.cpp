@@ -3,6 +3,7 @@
 #include "creature_manager.h"
 #include "creature_type.h"
 #include "game_data.h"
+#include "main_game_objects.h"
 #include <cassert>
 
 
@@ -11,28 +12,36 @@ const int msLo, const int msHi, const int nLo, const int nHi)
 : Creature(hp), distSpawnMS(msLo, msHi), distSpawnN(nLo, nHi), thisType(tType), spawnType(sType) {
 	assert((msLo >= 0) && (msHi >= msLo));
 	assert((nLo >= 1) && (nHi >= nLo));
-	setSpawnCounter();
 }
 
 
-void CreatureSpawner::updateTick(const Constants::float_type dt) {
-	timeRem -= dt;
-	if (timeRem <= 0) {
-		setSpawnCounter();
-		const int spawnCount = distSpawnN(GameData::instance().randGen);
-		for (int i = 0; i < spawnCount; ++i) {
-			//! TODO: check result, randomize position
-			cm->spawn(
-				spawnType,
-				static_cast<int>(entityPos.x),
-				static_cast<int>(entityPos.y)
-			);
-		}
-	}
+CreatureSpawner::~CreatureSpawner() {
+	if (timers != nullptr)
+		timers->cancel(spawnTimer);
 }
 
 
-void CreatureSpawner::setSpawnCounter() {
+// Schedule the next wave, call once spawned
+void CreatureSpawner::startSpawnTimer() {
 	const int timeMS = distSpawnMS(GameData::instance().randGen);
-	timeRem = (static_cast<Constants::float_type>(timeMS) / 1000);
+	timers = &GameData::instance().mgo->getTimers();
+	timers->cancel(spawnTimer);
+	spawnTimer = timers->add(static_cast<Constants::float_type>(timeMS) / 1000, [this]() {
+		spawnWave();
+	});
+}
+
+
+void CreatureSpawner::spawnWave() {
+	assert(cm != nullptr);
+	startSpawnTimer();
+	const int spawnCount = distSpawnN(GameData::instance().randGen);
+	for (int i = 0; i < spawnCount; ++i) {
+		//! TODO: check result, randomize position
+		cm->spawn(
+			spawnType,
+			static_cast<int>(entityPos.x),
+			static_cast<int>(entityPos.y)
+		);
+	}
 }
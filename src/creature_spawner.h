@@ -2,6 +2,7 @@
 
 #include "creature.h"
 #include "creature_type.h"
+#include "timer_wheel.h"
 #include "utility.h"
 #include <random>
 
@@ -9,17 +10,18 @@
 class CreatureSpawner : public Creature {
 public:
 	CreatureSpawner(const int, const CreatureType, const CreatureType, const int, const int, const int, const int);
-	virtual ~CreatureSpawner() {}
+	virtual ~CreatureSpawner();
 	virtual void spawn(CreatureManager*, const int, const int) = 0;
 protected:
-	void updateTick(const Constants::float_type);
+	void startSpawnTimer(void);
 private:
-	void setSpawnCounter(void);
+	void spawnWave(void);
 protected:
 	CreatureManager* cm = nullptr;
 	std::uniform_int_distribution<int> distSpawnMS;		// duration (ms) between spawns
 	std::uniform_int_distribution<int> distSpawnN;		// number spawned
-	Constants::float_type timeRem = 0;
+	TimerWheel* timers = nullptr;
+	TimerWheel::Handle spawnTimer;
 	CreatureType thisType = CreatureType::NONE;
 	CreatureType spawnType = CreatureType::NONE;
 };
@@ -29,6 +29,8 @@ public:
 
 
 // Represents something that has a defined position
+// prevPos is the position at the start of the current update, and is used to
+//   interpolate the drawn position between updates (see getDrawPos()).
 class GameEntity : public Entity {
 public:
 	GameEntity() {}
@@ -36,8 +38,11 @@ public:
 	virtual SDL_Rect getBounds(void) const = 0;
 	Vector2D<> getPos(void) const;
 	virtual void setPos(const Vector2D<>&);
+	void savePrevPos(void);
+	Vector2D<> getDrawPos(const Constants::float_type) const;
 protected:
 	Vector2D<> entityPos;
+	Vector2D<> prevPos;
 };
 
 
@@ -79,6 +84,20 @@ void GameEntity::setPos(const Vector2D<>& pos) {
 }
 
 
+// call at the start of update, and after position is set without moving (spawn, load)
+inline
+void GameEntity::savePrevPos() {
+	prevPos = entityPos;
+}
+
+
+// alpha is in [0, 1], where 0 is the previous position and 1 is the current position
+inline
+Vector2D<> GameEntity::getDrawPos(const Constants::float_type alpha) const {
+	return (prevPos + ((entityPos - prevPos) * alpha));
+}
+
+
 inline
 KillableGameEntity::KillableGameEntity(const int hp) : entityHealth(hp) {
 }
@@ -1,7 +1,11 @@
 #include "event_manager.h"
 #include "event_callback.h"
+#include "event_record.h"
 #include "game_data.h"
+#include "logger.h"
 #include "state_manager.h"
+#include "trace.h"
+#include <cassert>
 #ifndef NDEBUG
 #include "constants.h"
 #include <iomanip>
@@ -12,36 +16,114 @@ static std::string EventToString(const SDL_Event&);
 #endif // NDEBUG
 
 
+EventManager::EventManager() : doProcess(&self_type::processNormal) {
+}
+
+
+EventManager::~EventManager() {
+	delete recorder;
+	delete player;
+}
+
+
 void EventManager::clearMousePresses() {
 	SDL_FlushEvents(SDL_MOUSEBUTTONDOWN, SDL_MOUSEBUTTONUP);
 }
 
 
-void EventManager::process() {
+// Record events of every following tick to file at path
+void EventManager::startRecording(const std::string& path, const uint32_t seed) {
+	assert((recorder == nullptr) && (player == nullptr));
+	recorder = new EventRecorder{path, seed};
+	doProcess = &self_type::processRecord;
+}
+
+
+// Replace input with events recorded in file at path
+// Caller advances the recording with getPlayer()->nextTick() before each update
+void EventManager::startReplay(const std::string& path) {
+	assert((recorder == nullptr) && (player == nullptr));
+	player = new EventPlayer{path};
+	pendingMarkers = 0;
+	InputHandler::setKeyState(player->getKeyState());
+	doProcess = &self_type::processReplay;
+}
+
+
+void EventManager::processNormal(const Constants::float_type, const uint32_t) {
+	while (SDL_PollEvent(&e))
+		processEvent(e);
+}
+
+
+void EventManager::processRecord(const Constants::float_type dt, const uint32_t time) {
+	recorder->beginTick(dt, time);
+	while (SDL_PollEvent(&e)) {
+		recorder->add(e);
+		processEvent(e);
+	}
+	recorder->endTick();
+}
+
+
+// Recorded user events are markers, the matching event is the next one the game generated.
+// A marker replayed before its event exists stays pending, and is matched with the next
+//   generated event before anything else is processed, so later markers still line up.
+void EventManager::processReplay(const Constants::float_type, const uint32_t) {
 	while (SDL_PollEvent(&e)) {
+		if (e.type == SDL_QUIT)
+			processEvent(e);
+		else if (e.type >= SDL_USEREVENT)
+			userEvents.push_back(e);
+	}
+	for (; (pendingMarkers > 0) && !userEvents.empty(); --pendingMarkers) {
+		e = userEvents.front();
+		userEvents.pop_front();
+		processEvent(e);
+	}
+	for (const SDL_Event& re : player->getEvents()) {
+		if (re.type == EventRecordSettings::markerType) {
+			if (userEvents.empty()) {
+				Logger::instance().log("replay: user event not generated yet, replay may diverge");
+				++pendingMarkers;
+				continue;
+			}
+			e = userEvents.front();
+			userEvents.pop_front();
+			processEvent(e);
+		}
+		else {
+			processEvent(re);
+		}
+	}
+}
+
+
+void EventManager::processEvent(const SDL_Event& ev) {
 #ifndef NDEBUG
-		std::string eventStr = EventToString(e);
-		if (!eventStr.empty())
-			DEBUG_BEGIN << eventStr << std::endl;
+	std::string eventStr = EventToString(ev);
+	if (!eventStr.empty())
+		DEBUG_BEGIN << eventStr << std::endl;
 #endif // NDEBUG
-		switch (e.type) {
-		case SDL_MOUSEMOTION:
-		case SDL_MOUSEBUTTONDOWN:
-		case SDL_MOUSEBUTTONUP:
-		case SDL_KEYDOWN:
-		case SDL_KEYUP:
-		case SDL_TEXTINPUT:
-		case SDL_TEXTEDITING:
-			inputHandler.process(e);
-			break;
-		case SDL_QUIT:
-			SDL::clearEvents();
-			GameData::instance().stateManager->exit();
-			break;
-		default:
-			inputHandler.getCallbacks()->eventCallback(e);
-			break;
-		}
+	if ((ev.type == SDL_KEYDOWN) && (ev.key.keysym.sym == TraceSettings::flushKey) && Trace::isEnabled())
+		Trace::flush();
+	switch (ev.type) {
+	case SDL_MOUSEMOTION:
+	case SDL_MOUSEBUTTONDOWN:
+	case SDL_MOUSEBUTTONUP:
+	case SDL_KEYDOWN:
+	case SDL_KEYUP:
+	case SDL_TEXTINPUT:
+	case SDL_TEXTEDITING:
+		inputHandler.process(ev);
+		break;
+	case SDL_QUIT:
+		SDL::clearEvents();
+		GameData::instance().stateManager->exit();
+		break;
+	default:
+		inputHandler.getCallbacks()->eventCallback(ev);
+		break;
 	}
 }
 
@@ -1,21 +1,50 @@
 #pragma once
 
+#include "constants.h"
 #include "sdl_helper.h"
 #include "input_handler.h"
+#include "profiler.h"
+#include "trace.h"
+#include <cstdint>
+#include <deque>
+#include <string>
 
 
 class EventCallbackCollection;
+class EventPlayer;
+class EventRecorder;
 
 
+// Events can be recorded to a file and replayed from it (see event_record.h).
+// While replaying, all real input except quitting is ignored.
 class EventManager {
+	EventManager(const EventManager&) = delete;
+	void operator=(const EventManager&) = delete;
+	typedef EventManager self_type;
 public:
+	EventManager();
+	~EventManager();
 	InputHandler* getInputHandler(void);
 	void setCallbacks(EventCallbackCollection*);
 	void clearMousePresses(void);
-	void process(void);
+	void startRecording(const std::string&, const uint32_t);
+	void startReplay(const std::string&);
+	EventPlayer* getPlayer(void);	// nullptr if not replaying
+	// process events for an update tick of dt seconds, at time ms
+	void process(const Constants::float_type, const uint32_t);
 private:
+	void processNormal(const Constants::float_type, const uint32_t);
+	void processRecord(const Constants::float_type, const uint32_t);
+	void processReplay(const Constants::float_type, const uint32_t);
+	void processEvent(const SDL_Event&);
+
 	SDL_Event e;
 	InputHandler inputHandler;
+	std::deque<SDL_Event> userEvents;	// generated by game, waiting for their replay slot
+	std::size_t pendingMarkers = 0;	// replayed before their event was generated
+	void (self_type::*doProcess)(const Constants::float_type, const uint32_t);
+	EventRecorder* recorder = nullptr;
+	EventPlayer* player = nullptr;
 };
 
 
@@ -25,7 +54,21 @@ InputHandler* EventManager::getInputHandler() {
 }
 
 
+inline
+EventPlayer* EventManager::getPlayer() {
+	return player;
+}
+
+
 inline
 void EventManager::setCallbacks(EventCallbackCollection* p) {
 	inputHandler.setCallbacks(p);
 }
+
+
+inline
+void EventManager::process(const Constants::float_type dt, const uint32_t time) {
+	ProfileScope ps{Profiler::Zone::EVENTS};
+	TraceScope ts{"events"};
+	(this->*doProcess)(dt, time);
+}
@@ -0,0 +1,111 @@
+#include "event_record.h"
+#include "exception.h"
+#include "logger.h"
+#include "utility.h"	// q
+#include <cassert>
+#include <cstring>	// memcmp, memset
+
+
+namespace EventRecordHelper {
+
+template<class T>
+void write(std::ofstream& file, const T& val) {
+	file.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+
+template<class T>
+bool read(std::ifstream& file, T& val) {
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(&val), sizeof(val)));
+}
+
+}	// namespace EventRecordHelper
+
+
+EventRecorder::EventRecorder(const std::string& path, const uint32_t seed) {
+	using namespace EventRecordHelper;
+	file.open(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!file.is_open())
+		Logger::instance().exit(FileError{path, FileError::Err::NOT_OPEN});
+	file.write(EventRecordSettings::magic, sizeof(EventRecordSettings::magic));
+	write(file, EventRecordSettings::version);
+	write(file, seed);
+}
+
+
+void EventRecorder::beginTick(const Constants::float_type d, const uint32_t t) {
+	assert(events.empty());
+	dt = d;
+	time = t;
+}
+
+
+void EventRecorder::add(const SDL_Event& e) {
+	if (e.type >= SDL_USEREVENT) {
+		SDL_Event marker;
+		std::memset(&marker, 0, sizeof(marker));
+		marker.type = EventRecordSettings::markerType;
+		events.push_back(marker);
+	}
+	else {
+		events.push_back(e);
+	}
+}
+
+
+void EventRecorder::endTick() {
+	using namespace EventRecordHelper;
+	write(file, tick);
+	write(file, time);
+	write(file, dt);
+	write(file, static_cast<uint32_t>(events.size()));
+	if (!events.empty())
+		file.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(SDL_Event)));
+	events.clear();
+	++tick;
+}
+
+
+EventPlayer::EventPlayer(const std::string& p) : path(p) {
+	using namespace EventRecordHelper;
+	file.open(path, std::ifstream::in | std::ifstream::binary);
+	if (!file.is_open())
+		Logger::instance().exit(FileError{path, FileError::Err::NOT_OPEN});
+	char magic[sizeof(EventRecordSettings::magic)];
+	uint32_t version = 0;
+	file.read(magic, sizeof(magic));
+	if (!file || (std::memcmp(magic, EventRecordSettings::magic, sizeof(magic)) != 0))
+		Logger::instance().exit(FileError{path, "not an event recording"});
+	if (!read(file, version) || (version != EventRecordSettings::version))
+		Logger::instance().exit(FileError{path, "unsupported event recording version"});
+	if (!read(file, seed))
+		Logger::instance().exit(FileError{path, "event recording is truncated"});
+}
+
+
+// Read events of next tick and apply key presses to keyState, the same way
+//   SDL updates its keyboard state when events are pumped.
+bool EventPlayer::nextTick() {
+	using namespace EventRecordHelper;
+	uint32_t count = 0;
+	if (!read(file, tick))
+		return false;
+	if (!read(file, time) || !read(file, dt) || !read(file, count)) {
+		Logger::instance().log("Event recording " + q(path) + " is truncated");
+		return false;
+	}
+	events.resize(count);
+	if (count > 0) {
+		file.read(reinterpret_cast<char*>(events.data()), static_cast<std::streamsize>(count * sizeof(SDL_Event)));
+		if (!file) {
+			Logger::instance().log("Event recording " + q(path) + " is truncated");
+			events.clear();
+			return false;
+		}
+	}
+	for (const SDL_Event& e : events) {
+		if ((e.type == SDL_KEYDOWN) || (e.type == SDL_KEYUP))
+			keyState[e.key.keysym.scancode] = (e.key.state == SDL_PRESSED) ? 1 : 0;
+	}
+	return true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "constants.h"
+#include "sdl_header.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+// Binary file of the events processed by EventManager, grouped by update tick.
+// Native byte order, only meant to be replayed by the same build.
+//   header: magic, version, random seed
+//   tick: tick index, game time (ms), dt, event count, events
+// Events generated by the game (user events) are only stored as markers of
+//   where they were processed, since a replay generates them again.
+namespace EventRecordSettings {
+	constexpr char magic[] = {'m', 'r', 'e', 'v'};
+	constexpr uint32_t version = 1;
+	constexpr Uint32 markerType = SDL_USEREVENT;
+}
+
+
+class EventRecorder {
+	EventRecorder(const EventRecorder&) = delete;
+	void operator=(const EventRecorder&) = delete;
+public:
+	EventRecorder(const std::string&, const uint32_t);
+	~EventRecorder() = default;
+	void beginTick(const Constants::float_type, const uint32_t);
+	void add(const SDL_Event&);
+	void endTick(void);
+private:
+	std::ofstream file;
+	std::vector<SDL_Event> events;	// events of current tick
+	uint32_t tick = 0;
+	uint32_t time = 0;
+	Constants::float_type dt = 0;
+};
+
+
+class EventPlayer {
+	EventPlayer(const EventPlayer&) = delete;
+	void operator=(const EventPlayer&) = delete;
+public:
+	EventPlayer(const std::string&);
+	~EventPlayer() = default;
+	bool nextTick(void);	// false at end of recording
+	uint32_t getSeed(void) const;
+	uint32_t getTick(void) const;
+	uint32_t getTime(void) const;
+	Constants::float_type getDt(void) const;
+	const std::vector<SDL_Event>& getEvents(void) const;
+	const Uint8* getKeyState(void) const;
+private:
+	std::ifstream file;
+	std::string path;
+	std::vector<SDL_Event> events;	// events of current tick
+	Uint8 keyState[SDL_NUM_SCANCODES] = {};	// replaces SDL keyboard state
+	uint32_t seed = 0;
+	uint32_t tick = 0;
+	uint32_t time = 0;
+	Constants::float_type dt = 0;
+};
+
+
+inline
+uint32_t EventPlayer::getSeed() const {
+	return seed;
+}
+
+
+inline
+uint32_t EventPlayer::getTick() const {
+	return tick;
+}
+
+
+inline
+uint32_t EventPlayer::getTime() const {
+	return time;
+}
+
+
+inline
+Constants::float_type EventPlayer::getDt() const {
+	return dt;
+}
+
+
+inline
+const std::vector<SDL_Event>& EventPlayer::getEvents() const {
+	return events;
+}
+
+
+inline
+const Uint8* EventPlayer::getKeyState() const {
+	return keyState;
+}
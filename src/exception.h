@@ -7,6 +7,7 @@
 namespace SDLFunc {
 	constexpr char SDL_CreateRenderer[] = "SDL_CreateRenderer";
 	constexpr char SDL_CreateRGBSurface[] = "SDL_CreateRGBSurface";
+	constexpr char SDL_CreateTexture[] = "SDL_CreateTexture";
 	constexpr char SDL_CreateTextureFromSurface[] = "SDL_CreateTextureFromSurface";
 	constexpr char SDL_CreateWindow[] = "SDL_CreateWindow";
 	constexpr char SDL_GetNumRenderDrivers[] = "SDL_GetNumRenderDrivers";
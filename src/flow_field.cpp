@@ -0,0 +1,139 @@
+#include "flow_field.h"
+#include "constants.h"
+#include "room.h"
+#include <algorithm>	// fill, max, min
+#include <cassert>
+#include <limits>
+
+
+namespace FlowFieldHelper {
+
+// 8 neighbours, orthogonal first
+constexpr int offX[] = {0, 1, 0, -1, 1, 1, -1, -1};
+constexpr int offY[] = {-1, 0, 1, 0, -1, 1, 1, -1};
+constexpr std::size_t orthogonal = 4;
+
+}	// namespace FlowFieldHelper
+
+
+FlowField::FlowField() :
+	countX(Constants::roomWidth / Constants::CMFlowCellSz),
+	countY(Constants::roomHeight / Constants::CMFlowCellSz)
+{
+	const std::size_t count = static_cast<std::size_t>(countX * countY);
+	passable.assign(count, 1);
+	dist.assign(count, -1);
+	dirs.assign(count, Vector2D<>{0, 0});
+}
+
+
+// A cell is passable if it has no blocks
+void FlowField::setRoom(const Room& room) {
+	using Constants::CMFlowCellSz;
+	for (int y = 0; y < countY; ++y) {
+		for (int x = 0; x < countX; ++x) {
+			const SDL_Rect r{
+				Constants::RoomX + (x * CMFlowCellSz),
+				Constants::RoomY + (y * CMFlowCellSz),
+				CMFlowCellSz,
+				CMFlowCellSz
+			};
+			passable[static_cast<std::size_t>((y * countX) + x)] = room.space(r);
+		}
+	}
+	target = -1;
+}
+
+
+void FlowField::update(const SDL_Rect& t) {
+	const int cell = toCell(t.x + (t.w / 2), t.y + (t.h / 2));
+	if (cell == target)
+		return;
+	target = cell;
+	search();
+}
+
+
+// Direction to move from position (x, y), false if the position is next to or in
+//   the target cell or the target can't be reached
+bool FlowField::getDir(const int x, const int y, Vector2D<>& dir) const {
+	if (target < 0)
+		return false;
+	const std::size_t cell = static_cast<std::size_t>(toCell(x, y));
+	if (dist[cell] <= 1)
+		return false;
+	dir = dirs[cell];
+	return true;
+}
+
+
+// positions outside of the room are in the closest cell
+int FlowField::toCell(const int x, const int y) const {
+	using Constants::CMFlowCellSz;
+	const int cx = std::min(std::max((x - Constants::RoomX) / CMFlowCellSz, 0), countX - 1);
+	const int cy = std::min(std::max((y - Constants::RoomY) / CMFlowCellSz, 0), countY - 1);
+	return (cy * countX) + cx;
+}
+
+
+// Distances with orthogonal steps, then each cell points to its neighbour closest to
+//   the target. Diagonal moves are only taken if they don't cut a blocked corner.
+void FlowField::search() {
+	using namespace FlowFieldHelper;
+	std::fill(dist.begin(), dist.end(), -1);
+	std::vector<int> queue;
+	queue.reserve(dist.size());
+	dist[static_cast<std::size_t>(target)] = 0;
+	queue.push_back(target);
+	for (std::size_t i = 0; i < queue.size(); ++i) {
+		const int cell = queue[i];
+		const int cx = cell % countX;
+		const int cy = cell / countX;
+		for (std::size_t n = 0; n < orthogonal; ++n) {
+			const int nx = cx + offX[n];
+			const int ny = cy + offY[n];
+			if ((nx < 0) || (ny < 0) || (nx >= countX) || (ny >= countY))
+				continue;
+			const std::size_t next = static_cast<std::size_t>((ny * countX) + nx);
+			if (!passable[next] || (dist[next] >= 0))
+				continue;
+			dist[next] = dist[static_cast<std::size_t>(cell)] + 1;
+			queue.push_back(static_cast<int>(next));
+		}
+	}
+	auto open = [this](const int x, const int y) {
+		return (
+			(x >= 0) && (y >= 0) && (x < countX) && (y < countY)
+			&& (dist[static_cast<std::size_t>((y * countX) + x)] >= 0)
+		);
+	};
+	for (int cy = 0; cy < countY; ++cy) {
+		for (int cx = 0; cx < countX; ++cx) {
+			const std::size_t cell = static_cast<std::size_t>((cy * countX) + cx);
+			Vector2D<>& dir = dirs[cell];
+			dir = Vector2D<>{0, 0};
+			int bestScore = std::numeric_limits<int>::max();
+			for (std::size_t n = 0; n < (sizeof(offX) / sizeof(offX[0])); ++n) {
+				const int nx = cx + offX[n];
+				const int ny = cy + offY[n];
+				const bool diagonal = (n >= orthogonal);
+				if (!open(nx, ny) || (diagonal && (!open(nx, cy) || !open(cx, ny))))
+					continue;
+				// a diagonal step counts as 2 orthogonal ones, and must save both
+				const int d = dist[static_cast<std::size_t>((ny * countX) + nx)];
+				if (d >= (dist[cell] - (diagonal ? 1 : 0)))
+					continue;
+				const int score = d + (diagonal ? 2 : 1);
+				if ((score < bestScore) || ((score == bestScore) && diagonal)) {
+					bestScore = score;
+					dir = Vector2D<>{
+						static_cast<Vector2D<>::underlying_type>(offX[n]),
+						static_cast<Vector2D<>::underlying_type>(offY[n])
+					};
+				}
+			}
+			if ((dir.x != 0) || (dir.y != 0))
+				dir.normalize();
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "sdl_header.h"
+#include "utility_struct.h"
+#include <cstdint>
+#include <vector>
+
+
+class Room;
+
+
+// Direction to move from each cell of a coarse grid over the room to reach a target,
+//   found with a breadth first search from the target cell.
+// Only recomputed when the target moves to another cell, so any number of
+//   creatures can read it for the cost of a lookup.
+class FlowField {
+	FlowField(const FlowField&) = delete;
+	void operator=(const FlowField&) = delete;
+public:
+	FlowField();
+	~FlowField() = default;
+	void setRoom(const Room&);
+	void update(const SDL_Rect&);	// target bounds
+	bool getDir(const int, const int, Vector2D<>&) const;
+private:
+	int toCell(const int, const int) const;
+	void search(void);
+
+	std::vector<uint8_t> passable;
+	std::vector<int> dist;	// steps to target, -1 if unreachable
+	std::vector<Vector2D<>> dirs;	// normalized, to next cell on the way to target
+	int countX;
+	int countY;
+	int target = -1;	// cell
+};
@@ -1,11 +1,14 @@
 #include "game.h"
 #include "console.h"
+#include "event_record.h"
 #include "game_data.h"
 #include "game_state.h"
 #include "input_handler.h"
+#include "profiler.h"
 #include "settings.h"
+#include "trace.h"
 #include "utility.h"	// q
-#include <algorithm>	// max
+#include <algorithm>	// max, min
 #include <cassert>
 #include <cmath>	// ceil
 #include <cstring>	// strcmp
@@ -16,6 +19,23 @@
 Game::Game(Settings*& settings) {
 	dtMin = static_cast<Constants::float_type>(1.0 / settings->maxFPS);
 	dtMax = static_cast<Constants::float_type>(1.0 / settings->minFPS);
+	dtFixed = static_cast<Constants::float_type>(1.0 / settings->tickRate);
+	fixedStep = settings->getFlag(SettingsSettings::Index::FIXEDSTEP);
+	headlessTicks = settings->headlessTicks;
+	headless = settings->getFlag(SettingsSettings::Index::HEADLESS);
+	bench = settings->getFlag(SettingsSettings::Index::BENCH);
+	Profiler::setEnabled(settings->getFlag(SettingsSettings::Index::DISPLAYFPS) && !headless);
+	Profiler::setBudget(dtMin);
+	canvas.setBatching(settings->getFlag(SettingsSettings::Index::BATCHDRAW));
+	if (!settings->tracePath.empty())
+		Trace::open(settings->tracePath);
+	if (!settings->replayPath.empty()) {
+		eventManager.startReplay(settings->replayPath);
+		GameData::instance().setRandSeed(eventManager.getPlayer()->getSeed());
+	}
+	else if (!settings->recordPath.empty()) {
+		eventManager.startRecording(settings->recordPath, static_cast<uint32_t>(GameData::instance().randSeed));
+	}
 	GameData::instance().setDataPath(settings->dataPath);
 	GameData::instance().setSavePath(settings->savePath);
 	// update GameSettings
@@ -23,6 +43,15 @@ Game::Game(Settings*& settings) {
 		GameSettings::Index::PAUSEFOCUSLOST,
 		settings->getFlag(SettingsSettings::Index::PAUSEFOCUSLOST)
 	);
+	// a replay must go through the same states as the recording, so don't skip to the game
+	GameData::instance().settings.set(
+		GameSettings::Index::HEADLESS,
+		headless && (eventManager.getPlayer() == nullptr)
+	);
+	bench = (bench && (eventManager.getPlayer() == nullptr));
+	GameData::instance().settings.set(GameSettings::Index::BENCH, bench);
+	GameData::instance().settings.benchCreatures = settings->benchCreatures;
+	GameData::instance().settings.benchSpawners = settings->benchSpawners;
 	delete settings;
 	settings = nullptr;
 	stateManager.setEventManager(&eventManager);
@@ -35,6 +64,13 @@ Game::Game(Settings*& settings) {
 
 
 bool Game::init(const Settings& settings) {
+	const bool headless = settings.getFlag(SettingsSettings::Index::HEADLESS);
+	const bool bench = settings.getFlag(SettingsSettings::Index::BENCH);
+	if (headless) {
+		// no display needed, window and renderer still exist so resources can be loaded
+		SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+		SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+	}
 	if (!SDL::init())
 		return false;
 
@@ -43,7 +79,7 @@ bool Game::init(const Settings& settings) {
 
 	SDL::window = SDL::createWindow(
 		"mr", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-		Constants::windowWidth, Constants::windowHeight, SDL_WINDOW_SHOWN
+		Constants::windowWidth, Constants::windowHeight, headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN
 	);
 
 	// Create renderer
@@ -52,10 +88,10 @@ bool Game::init(const Settings& settings) {
 	int rendererIndex = -1;		// default value
 	SDL_SetHintWithPriority(	// set vsync preference
 		SDL_HINT_RENDER_VSYNC,
-		rendererPref.second ? SDLHintValue::TRUE : SDLHintValue::FALSE,
+		(rendererPref.second && !headless && !bench) ? SDLHintValue::TRUE : SDLHintValue::FALSE,
 		SDL_HINT_OVERRIDE
 	);
-	if (!rendererPref.first.empty()) {
+	if (!rendererPref.first.empty() && !headless) {
 		// preference is set, search for renderer
 		const int availDrivers = SDL::getNumRenderDrivers();
 		for (int i = 0; i < availDrivers; ++i) {
@@ -86,6 +122,8 @@ bool Game::init(const Settings& settings) {
 
 
 void Game::quit() {
+	Trace::close();
+	Profiler::freeResources();
 	SDL_DestroyRenderer(SDL::renderer);
 	SDL::renderer = nullptr;
 	SDL_DestroyWindow(SDL::window);
@@ -94,13 +132,26 @@ void Game::quit() {
 }
 
 
-// Variable time-step (dt, with fixed min/max).
-// Game progresses at constant time, unless FPS drops below a threshold.
 void Game::run() {
 	// begin initial GameState
 	stateManager.push(StateType::INIT);
 	stateManager.processEvents();
+	if (eventManager.getPlayer() != nullptr)
+		runReplay();
+	else if (bench)
+		runBench();
+	else if (headless)
+		runHeadless();
+	else if (fixedStep)
+		runFixed();
+	else
+		runVariable();
+}
+
 
+// Variable time-step (dt, with fixed min/max).
+// Game progresses at constant time, unless FPS drops below a threshold.
+void Game::runVariable() {
 	Uint32 prevTime;
 	Uint32 curTime;
 	Uint32 elapseTime;
@@ -126,6 +177,7 @@ void Game::run() {
 			elapse = static_cast<Constants::float_type>(elapseTime) / 1000;
 		}
 		prevTime = curTime;
+		Profiler::beginFrame();
 		if (elapse > dtMax) {
 			// running too slow
 			do {
@@ -142,19 +194,152 @@ void Game::run() {
 		draw();
 		canvas.present();
 		stateManager.processEvents();
+		Profiler::endFrame();
 		running = !stateManager.empty();
 	}
 }
 
 
+// Fixed time-step (dtFixed), decoupled from the frame rate.
+// Elapsed time is accumulated and consumed in dtFixed updates. Frames are drawn
+//   between updates, interpolating entity positions by the remaining fraction of a step.
+// Game time (GameData::time) is simulated time, so it advances exactly dtFixed per update.
+// If the game can't keep up, at most maxFrameSkip updates are done per frame and
+//   the rest of the elapsed time is dropped (game slows down instead of stalling).
+void Game::runFixed() {
+	const Uint64 freq = SDL_GetPerformanceFrequency();
+	const Uint64 frameCounts = static_cast<Uint64>(dtMin * freq);	// minimum counts per frame
+	const double dtStep = static_cast<double>(dtFixed);
+	const double maxAccumulate = (dtStep * Constants::maxFrameSkip);
+	double accumulator = 0;
+	double gameTime = 0;	// seconds
+	Uint64 prevCount = SDL_GetPerformanceCounter();
+	Uint64 curCount;
+	bool running = true;
+	while (running) {
+		curCount = SDL_GetPerformanceCounter();
+		Profiler::beginFrame();
+		accumulator += (static_cast<double>(curCount - prevCount) / freq);
+		prevCount = curCount;
+		if (accumulator > maxAccumulate)
+			accumulator = maxAccumulate;	// running too slow, drop time
+		while (accumulator >= dtStep) {
+			gameTime += dtStep;
+			update(dtFixed, static_cast<Uint32>(gameTime * 1000));
+			accumulator -= dtStep;
+			if (stateManager.eventWaiting())
+				break;	// state change must be processed before next update
+		}
+		canvas.setInterpolation(static_cast<Constants::float_type>(std::min(accumulator / dtStep, 1.0)));
+		draw();
+		canvas.present();
+		stateManager.processEvents();
+		Profiler::endFrame();
+		running = !stateManager.empty();
+		waitFrame(curCount, frameCounts);
+	}
+}
+
+
+// Run updates back to back with a fixed dt and no rendering, then report the
+//   update rate. Used to profile/test the simulation independently of the renderer.
+// States are drawn only until the game starts, since loading is done in draw().
+void Game::runHeadless() {
+	const double dtStep = static_cast<double>(dtFixed);
+	double gameTime = 0;	// seconds
+	while (!stateManager.empty() && (stateManager.top()->getType() != StateType::GAME)) {
+		gameTime += dtStep;
+		update(dtFixed, static_cast<Uint32>(gameTime * 1000));
+		draw();
+		stateManager.processEvents();
+	}
+	Console::begin() << "headless: running " << headlessTicks << " ticks" << std::endl;
+	const Uint64 startCount = SDL_GetPerformanceCounter();
+	long ticks = 0;
+	while (!stateManager.empty() && ((headlessTicks == 0) || (ticks < headlessTicks))) {
+		gameTime += dtStep;
+		update(dtFixed, static_cast<Uint32>(gameTime * 1000));
+		stateManager.processEvents();
+		++ticks;
+	}
+	reportTickRate("headless", ticks, startCount);
+	stateManager.exit();
+	stateManager.processEvents();
+}
+
+
+// Run the ticks of an event recording with their recorded dt and time.
+// In headless mode nothing is rendered (other than while loading) and ticks run
+//   back to back, otherwise frames are paced to the recorded dt.
+void Game::runReplay() {
+	EventPlayer* player = eventManager.getPlayer();
+	const Uint64 freq = SDL_GetPerformanceFrequency();
+	const Uint64 startCount = SDL_GetPerformanceCounter();
+	Uint64 curCount;
+	long ticks = 0;
+	while (!stateManager.empty() && player->nextTick()) {
+		curCount = SDL_GetPerformanceCounter();
+		Profiler::beginFrame();
+		update(player->getDt(), player->getTime());
+		if (!headless) {
+			draw();
+			canvas.present();
+		}
+		else if (stateManager.top()->getType() == StateType::INIT) {
+			draw();
+		}
+		stateManager.processEvents();
+		Profiler::endFrame();
+		++ticks;
+		if (!headless)
+			waitFrame(curCount, static_cast<Uint64>(player->getDt() * freq));
+	}
+	reportTickRate("replay", ticks, startCount);
+	stateManager.exit();
+	stateManager.processEvents();
+}
+
+
+// Run updates back to back with a fixed dt, drawing each one unless headless.
+// The benchmark state measures itself and exits when done.
+void Game::runBench() {
+	const double dtStep = static_cast<double>(dtFixed);
+	double gameTime = 0;	// seconds
+	while (!stateManager.empty()) {
+		gameTime += dtStep;
+		update(dtFixed, static_cast<Uint32>(gameTime * 1000));
+		if (!headless) {
+			draw();
+			canvas.present();
+		}
+		else if (stateManager.top()->getType() != StateType::BENCH) {
+			draw();	// loading
+		}
+		stateManager.processEvents();
+	}
+}
+
+
+void Game::reportTickRate(const char* mode, const long ticks, const Uint64 startCount) {
+	const double elapse = static_cast<double>(SDL_GetPerformanceCounter() - startCount) / SDL_GetPerformanceFrequency();
+	Console::begin() << mode << ": " << ticks << " ticks in " << elapse << " s ("
+	                 << (elapse > 0 ? (ticks / elapse) : 0) << " ticks/s)" << std::endl;
+}
+
+
 void Game::update(const Constants::float_type dt, const Uint32 cTime) {
-	eventManager.process();
-	GameData::instance().time = cTime;
-	stateManager.top()->update(dt);
+	{
+		TraceScope ts{"update"};
+		eventManager.process(dt, cTime);
+		GameData::instance().time = cTime;
+		stateManager.top()->update(dt);
+	}
+	Trace::drain();
 }
 
 
 void Game::draw() {
+	TraceScope ts{"draw"};
 	stateManager.top()->draw(canvas);
 #if defined(DEBUG_MOUSE_POS) && DEBUG_MOUSE_POS
 	auto oldColor = canvas.getColorState();
@@ -165,4 +350,22 @@ void Game::draw() {
 	canvas.fillRect(x, y - DEBUG_MOUSE_POS_SZ, 1, (DEBUG_MOUSE_POS_SZ * 2) + 1);	// vert
 	canvas.setColorState(oldColor);
 #endif // DEBUG_MOUSE_POS
+	// overlay needs the default font, which is loaded by the initial screen
+	if (stateManager.top()->getType() != StateType::INIT)
+		Profiler::draw(canvas);
+}
+
+
+// Wait until counts have passed since frameStart (from SDL_GetPerformanceCounter()).
+// SDL_Delay() is only accurate to a millisecond or so, so sleep for most of the
+//   remaining time and yield for the rest.
+void Game::waitFrame(const Uint64 frameStart, const Uint64 counts) {
+	const Uint64 freq = SDL_GetPerformanceFrequency();
+	const Uint64 end = (frameStart + counts);
+	Uint64 cur = SDL_GetPerformanceCounter();
+	while (cur < end) {
+		const Uint32 remainMS = static_cast<Uint32>(((end - cur) * 1000) / freq);
+		SDL_Delay(remainMS > 1 ? (remainMS - 1) : 0);
+		cur = SDL_GetPerformanceCounter();
+	}
 }
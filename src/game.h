@@ -19,8 +19,15 @@ public:
 	static void quit(void);
 	void run(void);
 private:
+	void runVariable(void);
+	void runFixed(void);
+	void runHeadless(void);
+	void runReplay(void);
+	void runBench(void);
+	static void reportTickRate(const char*, const long, const Uint64);
 	void update(const Constants::float_type, const Uint32);
 	void draw(void);
+	void waitFrame(const Uint64, const Uint64);
 
 	ResourceManager resourceManager;
 	Canvas canvas;
@@ -28,4 +35,9 @@ private:
 	EventManager eventManager;
 	Constants::float_type dtMin;
 	Constants::float_type dtMax;
+	Constants::float_type dtFixed;
+	long headlessTicks;
+	bool fixedStep;
+	bool headless;
+	bool bench;
 };
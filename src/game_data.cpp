@@ -12,7 +12,7 @@ static void checkPath(std::string& s) {
 }
 
 
-GameData::GameData() : randGen(seed()), exitCode(EXIT_SUCCESS) {
+GameData::GameData() : randSeed(seed()), randGen(randSeed), exitCode(EXIT_SUCCESS) {
 }
 
 
@@ -28,6 +28,12 @@ void GameData::setSavePath(const std::string& s) {
 }
 
 
+void GameData::setRandSeed(const std::random_device::result_type s) {
+	randSeed = s;
+	randGen.seed(randSeed);
+}
+
+
 std::random_device::result_type GameData::seed() {
 	std::random_device rd;
 	return rd();
@@ -26,6 +26,7 @@ public:
 	~GameData() {/* do nothing */}
 	void setDataPath(const std::string&);
 	void setSavePath(const std::string&);
+	void setRandSeed(const std::random_device::result_type);
 
 	WidgetData wData;
 	std::string dataPath;
@@ -37,6 +38,7 @@ public:
 	MainGameObjects* mgo = nullptr;
 	ResourceManager* resources = nullptr;
 	StateManager* stateManager = nullptr;
+	std::random_device::result_type randSeed;	// randGen was seeded with
 	std::default_random_engine randGen;
 	uint32_t time = 0;	// ms
 	int exitCode;
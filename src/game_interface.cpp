@@ -1,6 +1,7 @@
 #include "game_interface.h"
 #include "canvas.h"
 #include "game_data.h"
+#include "health_bar.h"
 #include "main_game_objects.h"
 #include "player.h"
 
@@ -17,4 +18,10 @@ void GameInterface::init() {
 
 void GameInterface::draw(Canvas& can) {
 	playerHealthBar->draw(can);
+	drawnHealth = playerHealthBar->getHealth();
+}
+
+
+bool GameInterface::changed() const {
+	return (playerHealthBar->getHealth() != drawnHealth);
 }
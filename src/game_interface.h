@@ -11,6 +11,8 @@ public:
 	~GameInterface();
 	void init(void);
 	void draw(Canvas&);
+	bool changed(void) const;	// since last drawn
 private:
 	HealthBar* playerHealthBar;
+	int drawnHealth = -1;
 };
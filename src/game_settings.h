@@ -7,11 +7,15 @@
 class GameSettings {
 	typedef std::size_t index_type;
 public:
-	enum class Index : index_type {PAUSEFOCUSLOST=0};
+	enum class Index : index_type {PAUSEFOCUSLOST=0, HEADLESS, BENCH};
 	void set(const Index, const bool=true);
 	bool test(const Index) const;
+
+	// only used with BENCH
+	int benchCreatures = 0;
+	int benchSpawners = 0;
 private:
-	std::bitset<1> flags;
+	std::bitset<3> flags;
 };
 
 
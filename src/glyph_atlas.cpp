@@ -0,0 +1,79 @@
+#include "glyph_atlas.h"
+#include "canvas.h"
+#include "exception.h"
+#include "logger.h"
+#include "sdl_helper.h"
+#include <cassert>
+#include <vector>
+
+
+constexpr std::size_t GlyphAtlas::glyphCount;
+
+
+// Glyphs are rendered as one char strings, so they are placed in the same box
+//   as in rendered text, then packed in rows of texWidth
+GlyphAtlas::GlyphAtlas(TTF_Font* font) : height(TTF_FontHeight(font)) {
+	using namespace GlyphAtlasSettings;
+	assert(font != nullptr);
+	const SDL_Color white{255, 255, 255, SDL_ALPHA_OPAQUE};
+	std::vector<SDL_Surface*> surfs(glyphCount, nullptr);
+	int x = 0;
+	int y = 0;
+	for (std::size_t i = 0; i < glyphCount; ++i) {
+		const char str[2] = {static_cast<char>(first + static_cast<char>(i)), '\0'};
+		int minX, maxX, minY, maxY;
+		SDL::glyphMetrics(font, static_cast<Uint16>(str[0]), &minX, &maxX, &minY, &maxY, &glyphs[i].advance);
+		glyphs[i].src = SDL_Rect{0, 0, 0, 0};
+		// space renders nothing visible, and may fail to render
+		if (str[0] == ' ')
+			continue;
+		surfs[i] = TTF_RenderText_Blended(font, str, white);
+		if (surfs[i] == nullptr)
+			Logger::instance().exit(SDLError{"unable to render glyph", SDLFunc::TTF_RenderText_});
+		if ((x + surfs[i]->w) > texWidth) {
+			x = 0;
+			y += height;
+		}
+		glyphs[i].src = SDL_Rect{x, y, surfs[i]->w, surfs[i]->h};
+		x += surfs[i]->w;
+	}
+	SDL_Surface* atlas = SDL::newSurface32(texWidth, y + height);
+	for (std::size_t i = 0; i < glyphCount; ++i) {
+		if (surfs[i] == nullptr)
+			continue;
+		// copy alpha as is
+		SDL_SetSurfaceBlendMode(surfs[i], SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(surfs[i], nullptr, atlas, &glyphs[i].src);
+		SDL::free(surfs[i]);
+	}
+	tex = SDL::toTexture(atlas);
+}
+
+
+GlyphAtlas::~GlyphAtlas() {
+	SDL::freeNull(tex);
+}
+
+
+// Draw str with its top left at (x, y)
+void GlyphAtlas::draw(Canvas& can, const std::string& str, const int x, const int y, const Color& c) {
+	SDL_SetTextureColorMod(tex, c.R, c.G, c.B);
+	SDL_Rect dst{x, y, 0, 0};
+	for (const char ch : str) {
+		const Glyph& g = get(ch);
+		if (g.src.w > 0) {
+			dst.w = g.src.w;
+			dst.h = g.src.h;
+			can.draw(tex, g.src, dst);
+		}
+		dst.x += g.advance;
+	}
+}
+
+
+int GlyphAtlas::width(const std::string& str) const {
+	int w = 0;
+	for (const char ch : str)
+		w += get(ch).advance;
+	return w;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "color.h"
+#include "sdl_header.h"
+#include <array>
+#include <string>
+
+
+class Canvas;
+
+
+namespace GlyphAtlasSettings {
+	constexpr char first = ' ';	// printable ASCII
+	constexpr char last = '~';
+	constexpr char missing = '?';	// drawn for chars outside [first, last]
+	constexpr int texWidth = 512;
+}
+
+
+// Printable ASCII glyphs of a font, rendered once in white to a texture, so text
+//   is drawn as a quad per char (colored with the texture color mod) without
+//   rasterizing.
+// Glyphs are placed by advance without kerning, so widths can differ a little
+//   from TTF_SizeText().
+// Created by ResourceManager, valid until its font is unloaded.
+class GlyphAtlas {
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	void operator=(const GlyphAtlas&) = delete;
+
+	struct Glyph {
+		SDL_Rect src;	// in tex, empty if nothing to draw
+		int advance;
+	};
+	static constexpr std::size_t glyphCount = static_cast<std::size_t>(GlyphAtlasSettings::last - GlyphAtlasSettings::first + 1);
+public:
+	GlyphAtlas(TTF_Font*);
+	~GlyphAtlas();
+	void draw(Canvas&, const std::string&, const int, const int, const Color&);
+	int width(const std::string&) const;
+	int getHeight(void) const;
+private:
+	const Glyph& get(const char) const;
+
+	std::array<Glyph, glyphCount> glyphs;
+	SDL_Texture* tex = nullptr;
+	int height;
+};
+
+
+inline
+int GlyphAtlas::getHeight() const {
+	return height;
+}
+
+
+inline
+const GlyphAtlas::Glyph& GlyphAtlas::get(const char c) const {
+	using namespace GlyphAtlasSettings;
+	const char g = (((c >= first) && (c <= last)) ? c : missing);
+	return glyphs[static_cast<std::size_t>(g - first)];
+}
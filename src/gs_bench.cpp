@@ -0,0 +1,217 @@
+#include "gs_bench.h"
+#include "alloc_counter.h"
+#include "canvas.h"
+#include "console.h"
+#include "exception.h"
+#include "game_data.h"
+#include "logger.h"
+#include "shapes.h"
+#include "spell.h"
+#include "state_manager.h"
+#include "trace.h"
+#include <algorithm>	// sort
+#include <memory>
+#include <random>
+#include <sstream>
+
+
+namespace BenchSettings {
+	constexpr std::random_device::result_type seed = 1;
+	constexpr long warmupTicks = 60;	// not measured
+	constexpr long measureTicks = 1200;
+	constexpr int pillarSz = 16;
+	constexpr int pillarGap = 64;	// pillar grid spacing
+	constexpr int spawnSz = 32;	// free area looked for to spawn a creature
+	constexpr int spawnTries = 64;
+	constexpr Constants::float_type spellInterval = 0.25;
+	constexpr char creatureName[] = "cr1";
+	constexpr char spawnerName[] = "cr1sp";
+}
+
+
+namespace BenchHelper {
+
+// Value at percentile p (0 to 100) of sorted values
+static double percentile(const std::vector<double>& sorted, const double p) {
+	if (sorted.empty())
+		return 0;
+	const std::size_t i = static_cast<std::size_t>((p / 100) * static_cast<double>(sorted.size() - 1));
+	return sorted[i];
+}
+
+
+static double toMS(const Uint64 counts) {
+	return ((static_cast<double>(counts) * 1000) / static_cast<double>(SDL_GetPerformanceFrequency()));
+}
+
+}	// namespace BenchHelper
+
+
+Benchmark::Benchmark(std::shared_ptr<StateContext> sc) : GameState(StateType::BENCH, sc), cm(&player, &room) {
+	using namespace BenchSettings;
+	getCallbacks()->setKey(SDLK_ESCAPE, CommonCallback::popStateK);
+	objects._AttackManager = &am;
+	objects._CreatureManager = &cm;
+	objects._Player = &player;
+	objects._Room = &room;
+	objects._SpellManager = &sm;
+	objects._Timers = &timers;
+	objects._VFXManager = &vfxm;
+	GameData::instance().mgo = &objects;
+	GameData::instance().setRandSeed(seed);
+	am.setCreatureManager(&cm);
+
+	TraceScope ts{"bench setup"};
+	setRoom();
+	spawn(CreatureType::T1, GameData::instance().settings.benchCreatures);
+	spawn(CreatureType::SP1, GameData::instance().settings.benchSpawners);
+	startCreatures = cm.count();
+	timers.add(spellInterval, [this]() {
+		castSpell();
+	});
+	frameMS.reserve(measureTicks);
+	updateMS.reserve(measureTicks);
+}
+
+
+Benchmark::~Benchmark() {
+	GameData::instance().mgo = nullptr;
+}
+
+
+void Benchmark::update(const Constants::float_type dt) {
+	using namespace BenchSettings;
+	const Uint64 count = SDL_GetPerformanceCounter();
+	if (ticks == warmupTicks) {
+		startCount = count;
+		startAllocs = AllocCounter::get();
+	}
+	else if (ticks > warmupTicks) {
+		frameMS.push_back(BenchHelper::toMS(count - prevCount));
+	}
+	prevCount = count;
+	if (ticks == (warmupTicks + measureTicks)) {
+		report();
+		GameData::instance().stateManager->exit();
+		return;
+	}
+	timers.update(dt);
+	player.update(dt);
+	cm.update(dt);
+	am.update(dt);
+	vfxm.update(dt);
+	if (ticks >= warmupTicks)
+		updateMS.push_back(BenchHelper::toMS(SDL_GetPerformanceCounter() - count));
+	++ticks;
+}
+
+
+void Benchmark::draw(Canvas& can) {
+	can.setColor(COLOR_BLACK, SDL_ALPHA_OPAQUE);
+	can.clearScreen();
+	room.draw(can);
+	player.draw(can);
+	cm.draw(can);
+	am.draw(can);
+	vfxm.draw(can);
+}
+
+
+void Benchmark::entered() {
+}
+
+
+void Benchmark::leaving(const StateType, std::shared_ptr<StateContext>) {
+}
+
+
+void Benchmark::obscuring(const StateType, std::shared_ptr<StateContext>) {
+}
+
+
+void Benchmark::revealed(std::shared_ptr<StateContext>) {
+}
+
+
+// Empty room with a grid of pillars, except where the player is.
+// One creature of each type is listed so CreatureManager loads their resources.
+void Benchmark::setRoom() {
+	using namespace BenchSettings;
+	const SDL_Rect playerBounds = player.getBounds();
+	std::stringstream ss;
+	ss << "{\"background\":[],\"conn\":{\"n\":[],\"e\":[],\"s\":[],\"w\":[]},\"block\":[";
+	bool first = true;
+	for (int y = (pillarGap - pillarSz) / 2; y <= (Constants::roomHeight - pillarSz); y += pillarGap) {
+		for (int x = (pillarGap - pillarSz) / 2; x <= (Constants::roomWidth - pillarSz); x += pillarGap) {
+			const SDL_Rect pillar{Constants::RoomX + x, Constants::RoomY + y, pillarSz, pillarSz};
+			if (Shape::intersects(pillar, playerBounds))
+				continue;
+			ss << (first ? "" : ",") << '[' << x << ',' << y << ',' << pillarSz << ',' << pillarSz << ']';
+			first = false;
+		}
+	}
+	ss << "],\"creatures\":["
+	   << "{\"name\":\"" << creatureName << "\",\"x\":" << Constants::RoomX << ",\"y\":" << Constants::RoomY << "},"
+	   << "{\"name\":\"" << spawnerName << "\",\"x\":" << Constants::RoomX << ",\"y\":" << Constants::RoomY << "}"
+	   << "]}";
+	auto data = std::make_shared<rapidjson::Document>();
+	data->Parse(ss.str().c_str());
+	if (data->HasParseError())
+		Logger::instance().exit(RuntimeError{"Benchmark::setRoom", "invalid room data"});
+	room.set(*data);
+	cm.setRoom(*data);
+}
+
+
+// Spawn n creatures at random places with free space around them
+void Benchmark::spawn(const CreatureType ct, const int n) {
+	using namespace BenchSettings;
+	std::uniform_int_distribution<int> distX{Constants::RoomX, Constants::RoomX + Constants::roomWidth - spawnSz};
+	std::uniform_int_distribution<int> distY{Constants::RoomY, Constants::RoomY + Constants::roomHeight - spawnSz};
+	auto& gen = GameData::instance().randGen;
+	for (int i = 0; i < n; ++i) {
+		int x = distX(gen);
+		int y = distY(gen);
+		for (int t = 1; (t < spawnTries) && !room.space(x, y, spawnSz, spawnSz); ++t) {
+			x = distX(gen);
+			y = distY(gen);
+		}
+		cm.spawn(ct, x, y);
+	}
+}
+
+
+// Release a basic spell at a random point, then schedule the next one
+void Benchmark::castSpell() {
+	using namespace BenchSettings;
+	std::uniform_int_distribution<int> distX{Constants::RoomX, Constants::RoomX + Constants::roomWidth - 1};
+	std::uniform_int_distribution<int> distY{Constants::RoomY, Constants::RoomY + Constants::roomHeight - 1};
+	auto& gen = GameData::instance().randGen;
+	Spell* spell = sm.newPlayerSpell(SpellType::BASIC);
+	spell->setPos(player.getBounds(), 0);
+	spell->savePrevPos();
+	spell->setEndPos(distX(gen), distY(gen), Constants::SMTravelSpeed);
+	am.add(spell);
+	timers.add(spellInterval, [this]() {
+		castSpell();
+	});
+}
+
+
+void Benchmark::report() {
+	using namespace BenchHelper;
+	const double elapse = (toMS(SDL_GetPerformanceCounter() - startCount) / 1000);
+	const uint64_t allocs = (AllocCounter::get() - startAllocs);
+	std::sort(frameMS.begin(), frameMS.end());
+	std::sort(updateMS.begin(), updateMS.end());
+	const long measured = static_cast<long>(updateMS.size());
+	Console::begin() << "bench: " << GameData::instance().settings.benchCreatures << " creatures, "
+	                 << GameData::instance().settings.benchSpawners << " spawners ("
+	                 << startCreatures << " at start, " << cm.count() << " at end)" << std::endl;
+	Console::begin() << "bench: " << measured << " ticks in " << elapse << " s ("
+	                 << (elapse > 0 ? (measured / elapse) : 0) << " ticks/s)" << std::endl;
+	Console::begin() << "bench: frame ms p50 " << percentile(frameMS, 50) << " p99 " << percentile(frameMS, 99)
+	                 << ", update ms p50 " << percentile(updateMS, 50) << " p99 " << percentile(updateMS, 99) << std::endl;
+	Console::begin() << "bench: " << allocs << " allocations ("
+	                 << (measured > 0 ? (static_cast<double>(allocs) / measured) : 0) << " per tick)" << std::endl;
+}
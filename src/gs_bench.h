@@ -0,0 +1,55 @@
+#pragma once
+
+#include "game_state.h"
+#include "sdl_helper.h"
+// Game components
+#include "attack_manager.h"
+#include "creature_manager.h"
+#include "main_game_objects.h"
+#include "player.h"
+#include "room.h"
+#include "spell_manager.h"
+#include "timer_wheel.h"
+#include "vfx_manager.h"
+#include <cstdint>
+#include <vector>
+
+
+// Creature stress test, started with --bench.
+// Spawns the requested number of Creature1 and Creature1Sp in a synthetic room with
+//   a grid of pillars, while the player casts spells at random points. After
+//   a fixed number of ticks it reports tick rate, frame and update times and
+//   allocations, then exits the game.
+// The random generator is reseeded, so runs with the same arguments do the same work.
+class Benchmark : public GameState {
+public:
+	Benchmark(std::shared_ptr<StateContext>);
+	~Benchmark();
+	void update(const Constants::float_type) override;
+	void draw(Canvas&) override;
+	void entered(void) override;
+	void leaving(const StateType, std::shared_ptr<StateContext>) override;
+	void obscuring(const StateType, std::shared_ptr<StateContext>) override;
+	void revealed(std::shared_ptr<StateContext>) override;
+private:
+	void setRoom(void);
+	void spawn(const CreatureType, const int);
+	void castSpell(void);
+	void report(void);
+
+	TimerWheel timers;
+	Player player;
+	SpellManager sm;
+	Room room;
+	CreatureManager cm;
+	AttackManager am;
+	VFXManager vfxm;
+	MainGameObjects objects;
+	std::vector<double> frameMS;	// from the start of one update to the next
+	std::vector<double> updateMS;
+	Uint64 startCount = 0;
+	Uint64 prevCount = 0;	// start of previous update
+	uint64_t startAllocs = 0;
+	std::size_t startCreatures = 0;
+	long ticks = 0;
+};
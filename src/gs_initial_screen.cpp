@@ -5,7 +5,9 @@
 #include "font.h"
 #include "game_data.h"
 #include "logger.h"
+#include "parameters.h"
 #include "resource_manager.h"
+#include "state_context.h"
 #include "state_manager.h"
 #include "text_renderer.h"
 #include "widget_layout.h"
@@ -98,7 +100,13 @@ InitialScreen::~InitialScreen() {
 
 void InitialScreen::update(const Constants::float_type) {
 	if (counter.finished()) {
-		GameData::instance().stateManager->switchTo(StateType::MENU);
+		// benchmark and headless mode skip the menu
+		if (GameData::instance().settings.test(GameSettings::Index::BENCH))
+			GameData::instance().stateManager->switchTo(StateType::BENCH);
+		else if (GameData::instance().settings.test(GameSettings::Index::HEADLESS))
+			GameData::instance().stateManager->switchTo(StateType::GAME);
+		else
+			GameData::instance().stateManager->switchTo(StateType::MENU);
 		return;
 	}
 }
@@ -143,7 +151,9 @@ void InitialScreen::entered() {
 }
 
 
-void InitialScreen::leaving(const StateType, std::shared_ptr<StateContext>) {
+void InitialScreen::leaving(const StateType st, std::shared_ptr<StateContext> sc) {
+	if (st == StateType::GAME)
+		sc->mIntInt.emplace(Parameters::NEW_GAME, 0);	// value doesn't matter
 }
 
 
@@ -4,6 +4,7 @@
 #include "image.h"
 #include "input_handler.h"
 #include "parameters.h"
+#include "profiler.h"
 #include "resource_manager.h"
 #include "save_data.h"
 #include "save_helper.h"
@@ -35,6 +36,7 @@ MainGame::MainGame(std::shared_ptr<StateContext> sc) : GameState(StateType::GAME
 	objects._Player = &player;
 	objects._Room = &room;
 	objects._SpellManager = &sm;
+	objects._Timers = &timers;
 	objects._VFXManager = &vfxm;
 	GameData::instance().mgo = &objects;
 
@@ -64,6 +66,7 @@ MainGame::~MainGame() {
 
 
 void MainGame::update(const Constants::float_type dt) {
+	timers.update(dt);
 	player.setDirection(playerDirection);
 	player.update(dt);
 	(this->*updateFunc)(dt);
@@ -71,11 +74,23 @@ void MainGame::update(const Constants::float_type dt) {
 
 
 void MainGame::draw(Canvas& can) {
-	can.setColor(COLOR_BLACK, SDL_ALPHA_OPAQUE);
-	can.clearScreen();
-	room.draw(can);
-	gi.draw(can);
-	player.draw(can);
+	if (gi.changed())
+		background.invalidate();
+	can.drawLayer(background, [this](Canvas& c) {
+		c.setColor(COLOR_BLACK, SDL_ALPHA_OPAQUE);
+		c.clearScreen();
+		{
+			ProfileScope ps{Profiler::Zone::DRAW_ROOM};
+			room.draw(c);
+		}
+		ProfileScope ps{Profiler::Zone::DRAW_GI};
+		gi.draw(c);
+	});
+	{
+		ProfileScope ps{Profiler::Zone::DRAW_PLAYER};
+		player.draw(can);
+	}
+	ProfileScope ps{Profiler::Zone::DRAW_MANAGERS};
 	(this->*drawFunc)(can);
 }
 
@@ -108,14 +123,20 @@ void MainGame::revealed(std::shared_ptr<StateContext>) {
 
 
 void MainGame::updateRunning(const Constants::float_type dt) {
-	cm.update(dt);
-	am.update(dt);
-	vfxm.update(dt);
+	{
+		ProfileScope ps{Profiler::Zone::UPDATE_CM};
+		cm.update(dt);
+	}
+	updateCleared(dt);
 }
 
 
 void MainGame::updateCleared(const Constants::float_type dt) {
-	am.update(dt);
+	{
+		ProfileScope ps{Profiler::Zone::UPDATE_AM};
+		am.update(dt);
+	}
+	ProfileScope ps{Profiler::Zone::UPDATE_VFXM};
 	vfxm.update(dt);
 }
 
@@ -134,10 +155,15 @@ void MainGame::drawCleared(Canvas& can) {
 }
 
 
+// Menu background is the current frame drawn again into a texture, so the
+//   screen isn't read back. Copy the screen if render targets can't be used.
 void MainGame::obscureToMenu(std::shared_ptr<StateContext> sc) {
 	// generate background image
-	SDL_Surface* surf = SDL::copyScreen();
-	SDL_Texture* tex = SDL::toTexture(surf);
+	SDL_Texture* tex = GameData::instance().canvas->renderToTexture([this](Canvas& can) {
+		draw(can);
+	});
+	if (tex == nullptr)
+		tex = SDL::toTexture(SDL::copyScreen());
 	sc->images.emplace("background", std::make_shared<Image>(tex));
 }
 
@@ -182,6 +208,11 @@ void MainGame::playerDirCallback(const KeyEvent& e, const int dir) {
 void MainGame::eventCallback(const SDL_Event& e) {
 	using std::placeholders::_1;
 	switch (e.type) {
+	case SDL_RENDER_TARGETS_RESET:
+	case SDL_RENDER_DEVICE_RESET:
+		// contents of render targets are lost
+		background.invalidate();
+		break;
 	case SDL_WINDOWEVENT:
 		if (e.window.event == SDL_WINDOWEVENT_FOCUS_LOST) {
 			if (GameData::instance().settings.test(GameSettings::Index::PAUSEFOCUSLOST))
@@ -195,6 +226,7 @@ void MainGame::eventCallback(const SDL_Event& e) {
 				map.setClear(map.getCurX(), map.getCurY());
 				map.notifyMoved();
 				room.notifyClear();
+				background.invalidate();
 			}
 		}
 	}
@@ -240,6 +272,7 @@ void MainGame::load(const std::string& name) {
 	auto roomData = GameData::instance().resources->getRoomData(data->roomX, data->roomY);
 	room.set(*roomData);
 	room.notifyClear();
+	background.invalidate();
 }
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "canvas.h"	// CanvasLayer
 #include "game_state.h"
 #include "sdl_helper.h"
 // Game components
@@ -9,6 +10,7 @@
 #include "attack_manager.h"
 #include "room.h"
 #include "spell_manager.h"
+#include "timer_wheel.h"
 #include "vfx_manager.h"
 #include "map.h"
 #include "main_game_objects.h"
@@ -41,6 +43,7 @@ private:
 	void load(const std::string&);
 	void save(const std::string&);
 
+	TimerWheel timers;	// first, so game objects can cancel timers when destroyed
 	Player player;
 	SpellManager sm;
 	Room room;
@@ -50,6 +53,7 @@ private:
 	Map map;
 	GameInterface gi;
 	MainGameObjects objects;
+	CanvasLayer background;	// room and interface
 	SDL_Keycode playerDirKeys[4];	// N, E, S, W
 	int playerDirection = PLAYER_DIR_NONE;
 	void (self_type::*updateFunc)(const Constants::float_type);
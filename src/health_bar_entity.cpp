@@ -3,10 +3,11 @@
 #include "constants.h"
 #include "entity.h"
 #include "game_data.h"
+#include "main_game_objects.h"
 
 
 namespace EntityHealthBarSettings {
-	constexpr uint32_t drawDuration = 5000;	// duration bar is drawn after entity damaged
+	constexpr Constants::float_type drawDuration = 5;	// seconds bar is drawn after entity damaged
 	constexpr int bgWidth = 22;
 	constexpr int bgHeight = 5;
 	constexpr int padFill = 1;
@@ -20,27 +21,33 @@ EntityHealthBar::EntityHealthBar(const KillableGameEntity* e, const int hp) : He
 }
 
 
+EntityHealthBar::~EntityHealthBar() {
+	if (timers != nullptr)
+		timers->cancel(hideTimer);
+}
+
+
 // Bar is drawn centered horizontally and just below entity bounds
 void EntityHealthBar::draw(Canvas& can) {
 	using namespace EntityHealthBarSettings;
 	if (drawTest) {
-		drawTest = ((GameData::instance().time - damageTime) < drawDuration);
-		if (drawTest) {
-			SDL_Rect entityBounds = entity->getBounds();
-			SDL_Rect dst;
-			dst.w = bgWidth;
-			dst.h = bgHeight;
-			dst.x = (entityBounds.x + ((entityBounds.w - dst.w) / 2));
-			dst.y = (entityBounds.y + entityBounds.h + padBounds);
-			can.setColor(colBg);
-			can.fillRect(dst);
-			dst.x += padFill;
-			dst.y += padFill;
-			dst.h -= (padFill * 2);
-			dst.w = barWidth;
-			can.setColor(colBar);
-			can.fillRect(dst);
-		}
+		SDL_Rect entityBounds = entity->getBounds();
+		const Vector2D<> drawPos = entity->getDrawPos(can.getInterpolation());
+		entityBounds.x = static_cast<int>(drawPos.x);
+		entityBounds.y = static_cast<int>(drawPos.y);
+		SDL_Rect dst;
+		dst.w = bgWidth;
+		dst.h = bgHeight;
+		dst.x = (entityBounds.x + ((entityBounds.w - dst.w) / 2));
+		dst.y = (entityBounds.y + entityBounds.h + padBounds);
+		can.setColor(colBg);
+		can.fillRect(dst);
+		dst.x += padFill;
+		dst.y += padFill;
+		dst.h -= (padFill * 2);
+		dst.w = barWidth;
+		can.setColor(colBar);
+		can.fillRect(dst);
 	}
 }
 
@@ -48,7 +55,12 @@ void EntityHealthBar::draw(Canvas& can) {
 void EntityHealthBar::set(const int hp) {
 	using namespace EntityHealthBarSettings;
 	health = hp;
-	damageTime = GameData::instance().time;
+	// restart the hide timer
+	timers = &GameData::instance().mgo->getTimers();
+	timers->cancel(hideTimer);
+	hideTimer = timers->add(drawDuration, [this]() {
+		drawTest = false;
+	});
 	drawTest = true;
 	barWidth = static_cast<int>(getRatio() * (bgWidth - (padFill * 2)));
 }
@@ -1,17 +1,19 @@
 #pragma once
 
 #include "health_bar.h"
-#include <cstdint>
+#include "timer_wheel.h"
 
 
+// Drawn for a while after the entity is damaged
 class EntityHealthBar : public HealthBar {
 public:
 	EntityHealthBar(const KillableGameEntity*, const int);
-	~EntityHealthBar() = default;
+	~EntityHealthBar();
 	void draw(Canvas&) override;
 	void set(const int) override;
 private:
-	uint32_t damageTime = 0;
+	TimerWheel* timers = nullptr;
+	TimerWheel::Handle hideTimer;
 	int barWidth = 0;
-	bool drawTest = false;	// needed since just damageTime is not enough
+	bool drawTest = false;
 };
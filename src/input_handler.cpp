@@ -20,6 +20,12 @@ void InputHandler::init() {
 }
 
 
+void InputHandler::setKeyState(const Uint8* state) {
+	assert(state != nullptr);
+	keyState = state;
+}
+
+
 void InputHandler::setTextInputWidget(Widget* w) {
 	textInputWidget = w;
 }
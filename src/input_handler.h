@@ -19,6 +19,7 @@ public:
 	InputHandler();
 	~InputHandler() {}
 	static void init(void);
+	static void setKeyState(const Uint8*);	// replaces SDL keyboard state
 
 	bool isPressed(const SDL_Keycode);
 	// mouse functions
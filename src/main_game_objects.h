@@ -9,10 +9,12 @@ class CreatureManager;
 class Player;
 class Room;
 class SpellManager;
+class TimerWheel;
 class VFXManager;
 
 
 class MainGameObjects {
+	friend class Benchmark;
 	friend class MainGame;
 public:
 	MainGameObjects() = default;
@@ -24,6 +26,7 @@ public:
 	Player& getPlayer() {return *_Player;}
 	Room& getRoom() {return *_Room;}
 	SpellManager& getSpellManager() {return *_SpellManager;}
+	TimerWheel& getTimers() {return *_Timers;}
 	VFXManager& getVFXManager() {return *_VFXManager;}
 private:
 	std::function<void(const std::string&)> saveFunction;
@@ -32,5 +35,6 @@ private:
 	Player* _Player = nullptr;
 	Room* _Room = nullptr;
 	SpellManager* _SpellManager = nullptr;
+	TimerWheel* _Timers = nullptr;
 	VFXManager* _VFXManager = nullptr;
 };
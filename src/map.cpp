@@ -1,7 +1,9 @@
 #include "map.h"
 #include "canvas.h"
+#include "exception.h"
 #include "game_data.h"
 #include "input_handler.h"
+#include "logger.h"
 #include "save_data.h"
 #include <algorithm>	// max
 #include <cmath>		// abs
@@ -17,6 +19,8 @@ namespace MapSettings {
 	constexpr int distAlphaX = 100;
 	constexpr int distAlphaY = 200;
 	constexpr Uint8 minAlpha = 25;
+	// more changed blocks than this copy the whole surface
+	constexpr std::size_t maxDirty = 8;
 }
 
 
@@ -46,9 +50,16 @@ Map::Map() : tex(nullptr) {
 	dst.x = Constants::RoomX + Constants::roomWidth - dst.w;
 	dst.y = Constants::RoomY + Constants::roomHeight - dst.h;
 	surf = SDL::newSurface32(dst.w, dst.h);
+	tex = SDL_CreateTexture(SDL::renderer, surf->format->format, SDL_TEXTUREACCESS_STREAMING, dst.w, dst.h);
+	if (tex == nullptr)
+		Logger::instance().exit(SDLError{"unable to create map texture", SDLFunc::SDL_CreateTexture});
+	SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+	SDL_SetTextureAlphaMod(tex, alpha);
+	dirty.reserve(MapSettings::maxDirty);
 	// draw default
 	Uint32 col = SDL::mapRGB(surf->format, MapSettings::bgColor);
 	SDL_FillRect(surf, nullptr, col);
+	dirtyAll = true;
 	col = SDL::mapRGB(surf->format, MapSettings::unclearColor);
 	for (int x = 0; x < Constants::MapCountX; ++x) {
 		for (int y = 0; y < Constants::MapCountY; ++y) {
@@ -66,6 +77,8 @@ Map::~Map() {
 
 
 void Map::draw(Canvas& can) {
+	if (dirtyAll || !dirty.empty())
+		refresh();
 	can.draw(tex, &dst);
 }
 
@@ -90,7 +103,7 @@ void Map::setCur(const int x, const int y) {
 void Map::setClear(const int x, const int y) {
 	vec.set(vecIndex(x, y));
 	// if setClear called on current room, do not draw yet
-	if ((x == curX) && (y == curX)) {
+	if ((x == curX) && (y == curY)) {
 		drawX = x;
 		drawY = y;
 	}
@@ -101,9 +114,21 @@ void Map::setClear(const int x, const int y) {
 
 // update texture after modifying surface
 void Map::refresh() {
-	SDL::freeNull(tex);
-	tex = SDL::newTexture(surf);
-	SDL_SetTextureAlphaMod(tex, alpha);
+	if (dirtyAll) {
+		if (SDL_UpdateTexture(tex, nullptr, surf->pixels, surf->pitch) != 0)
+			SDL::logError("Map::refresh SDL_UpdateTexture");
+	}
+	for (const SDL_Rect& r : dirty) {
+		const Uint8* pixels = (
+			static_cast<const Uint8*>(surf->pixels)
+			+ (r.y * surf->pitch)
+			+ (r.x * surf->format->BytesPerPixel)
+		);
+		if (SDL_UpdateTexture(tex, &r, pixels, surf->pitch) != 0)
+			SDL::logError("Map::refresh SDL_UpdateTexture");
+	}
+	dirty.clear();
+	dirtyAll = false;
 }
 
 
@@ -158,6 +183,7 @@ void Map::drawBlock(const int x, const int y, uint32_t col) {
 	assert((y >= 0) && (y < Constants::MapCountY));
 	setFillRect(x, y);
 	SDL_FillRect(surf, &dstFill, col);
+	addDirty(dstFill);
 }
 
 
@@ -169,3 +195,15 @@ void Map::setFillRect(const int x, const int y) {
 	dstFill.x += x * (Constants::MapBlockSz + MapSettings::blockPad);
 	dstFill.y -= y * (Constants::MapBlockSz + MapSettings::blockPad);
 }
+
+
+void Map::addDirty(const SDL_Rect& r) {
+	if (dirtyAll)
+		return;
+	if (dirty.size() == MapSettings::maxDirty) {
+		dirty.clear();
+		dirtyAll = true;
+		return;
+	}
+	dirty.push_back(r);
+}
@@ -5,6 +5,7 @@
 #include "sdl_helper.h"
 #include <cassert>
 #include <cstdint>
+#include <vector>
 
 
 class Canvas;
@@ -13,6 +14,8 @@ class SaveData;
 
 // Usage: call setClear, then setCur on init
 // Note: room (0, 0) is the bottom left
+// Blocks are drawn to surf, and only the changed areas are copied to the
+//   streaming texture on refresh(), which draw() calls when needed.
 class Map {
 	typedef BitVector<Constants::MapCountX * Constants::MapCountY> MapBitVector;
 	Map(const Map&) = delete;
@@ -33,6 +36,7 @@ public:
 private:
 	void drawBlock(const int, const int, uint32_t);
 	void setFillRect(const int, const int);
+	void addDirty(const SDL_Rect&);
 	std::size_t vecIndex(const int, const int) const;
 
 	MapBitVector vec;
@@ -40,6 +44,8 @@ private:
 	SDL_Rect dstFill;	// fill rect for surface
 	SDL_Surface* surf;
 	SDL_Texture* tex;
+	std::vector<SDL_Rect> dirty;	// areas of surf not copied to tex yet
+	bool dirtyAll = false;	// whole surf, dirty is empty
 	int curX;
 	int curY;
 	int drawX;
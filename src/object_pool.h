@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>	// placement new
+#include <type_traits>	// aligned_storage
+#include <utility>	// forward
+#include <vector>
+
+
+// Storage for objects of one type in chunks of ChunkSize slots, so objects never move
+//   and creating one only allocates when all chunks are full.
+// Destroyed slots are reused by the next create().
+// Each slot stores its index after the object, so destroy() finds it without a
+//   search. Only objects created by the pool may be given to destroy().
+// forEach() visits objects in slot order, objects may be created or destroyed during it.
+template<typename T, std::size_t ChunkSize = 64>
+class ObjectPool {
+	ObjectPool(const ObjectPool&) = delete;
+	void operator=(const ObjectPool&) = delete;
+
+	// obj is the first member, so a T* from the pool is also a Slot*
+	struct Slot {
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type obj;
+		std::size_t index;
+	};
+
+	struct Chunk {
+		Slot slots[ChunkSize];
+		bool alive[ChunkSize];
+	};
+public:
+	ObjectPool() = default;
+	~ObjectPool();
+	template<typename... Args>
+	T* create(Args&&...);
+	void destroy(T*);
+	std::size_t size(void) const;
+	bool empty(void) const;
+	template<typename F>
+	void forEach(F);
+	// chunks can be visited from different threads, if nothing is created or destroyed
+	std::size_t chunkCount(void) const;
+	template<typename F>
+	void forEachIn(const std::size_t, F);
+	void clear(void);
+private:
+	T* get(const std::size_t);
+	static std::size_t indexOf(const T*);
+
+	std::vector<std::unique_ptr<Chunk>> chunks;
+	std::vector<std::size_t> freeSlots;
+	std::size_t count = 0;
+};
+
+
+template<typename T, std::size_t ChunkSize>
+ObjectPool<T, ChunkSize>::~ObjectPool() {
+	clear();
+}
+
+
+template<typename T, std::size_t ChunkSize>
+template<typename... Args>
+T* ObjectPool<T, ChunkSize>::create(Args&&... args) {
+	if (freeSlots.empty()) {
+		const std::size_t first = chunks.size() * ChunkSize;
+		chunks.emplace_back(new Chunk());	// value initialized, so nothing is alive
+		// reversed so slots are used in order
+		for (std::size_t i = ChunkSize; i > 0; --i)
+			freeSlots.push_back(first + i - 1);
+	}
+	const std::size_t index = freeSlots.back();
+	freeSlots.pop_back();
+	Chunk& chunk = *chunks[index / ChunkSize];
+	Slot& slot = chunk.slots[index % ChunkSize];
+	T* obj = new (&slot.obj) T(std::forward<Args>(args)...);
+	slot.index = index;
+	chunk.alive[index % ChunkSize] = true;
+	++count;
+	return obj;
+}
+
+
+template<typename T, std::size_t ChunkSize>
+void ObjectPool<T, ChunkSize>::destroy(T* obj) {
+	assert(obj != nullptr);
+	const std::size_t index = indexOf(obj);
+	assert((index / ChunkSize) < chunks.size());
+	assert(get(index) == obj);
+	Chunk& chunk = *chunks[index / ChunkSize];
+	assert(chunk.alive[index % ChunkSize]);
+	chunk.alive[index % ChunkSize] = false;
+	obj->~T();
+	freeSlots.push_back(index);
+	--count;
+}
+
+
+template<typename T, std::size_t ChunkSize>
+std::size_t ObjectPool<T, ChunkSize>::size() const {
+	return count;
+}
+
+
+template<typename T, std::size_t ChunkSize>
+bool ObjectPool<T, ChunkSize>::empty() const {
+	return (count == 0);
+}
+
+
+template<typename T, std::size_t ChunkSize>
+template<typename F>
+void ObjectPool<T, ChunkSize>::forEach(F f) {
+	// chunks may be added by f
+	for (std::size_t c = 0; c < chunks.size(); ++c)
+		forEachIn(c, f);
+}
+
+
+template<typename T, std::size_t ChunkSize>
+std::size_t ObjectPool<T, ChunkSize>::chunkCount() const {
+	return chunks.size();
+}
+
+
+template<typename T, std::size_t ChunkSize>
+template<typename F>
+void ObjectPool<T, ChunkSize>::forEachIn(const std::size_t c, F f) {
+	assert(c < chunks.size());
+	for (std::size_t i = 0; i < ChunkSize; ++i) {
+		if (chunks[c]->alive[i])
+			f(*get((c * ChunkSize) + i));
+	}
+}
+
+
+template<typename T, std::size_t ChunkSize>
+void ObjectPool<T, ChunkSize>::clear() {
+	forEach([](T& obj) {
+		obj.~T();
+	});
+	chunks.clear();
+	freeSlots.clear();
+	count = 0;
+}
+
+
+template<typename T, std::size_t ChunkSize>
+T* ObjectPool<T, ChunkSize>::get(const std::size_t index) {
+	return reinterpret_cast<T*>(&chunks[index / ChunkSize]->slots[index % ChunkSize].obj);
+}
+
+
+// Index of the slot holding obj, which must have been created by a pool
+template<typename T, std::size_t ChunkSize>
+std::size_t ObjectPool<T, ChunkSize>::indexOf(const T* obj) {
+	return reinterpret_cast<const Slot*>(obj)->index;
+}
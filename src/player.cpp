@@ -44,6 +44,7 @@ Player::Player()
 , speed(Constants::PBaseMovSpeed) {
 	entityPos.x = 200;	// default values
 	entityPos.y = 200;
+	savePrevPos();
 	EntityResource* res = GameData::instance().resources->getEntity(this, EntityResourceID::PLAYER);
 	PlayerResource* pRes = dynamic_cast<PlayerResource*>(res);
 	ms.addState(pRes->ss->get("player_l"));
@@ -51,15 +52,15 @@ Player::Player()
 }
 
 
+// a charging spell is destroyed with AttackManager's pool
 Player::~Player() {
-	if (spell != nullptr)
-		delete spell;
 	GameData::instance().resources->freeEntity(this, EntityResourceID::PLAYER);
 }
 
 
 bool Player::update(const Constants::float_type dt) {
 	const Constants::float_type delta = (speed * dt);
+	savePrevPos();
 	if (moving) {
 		switch (direction) {
 		case PlayerDirection::NONE:
@@ -99,6 +100,7 @@ bool Player::update(const Constants::float_type dt) {
 		}
 	}
 	if (spell != nullptr) {
+		spell->savePrevPos();
 		spell->chargeTick(dt);
 		updateSpellPos();
 	}
@@ -107,7 +109,8 @@ bool Player::update(const Constants::float_type dt) {
 
 
 void Player::draw(Canvas& can) {
-	can.draw(ms, static_cast<int>(entityPos.x), static_cast<int>(entityPos.y));
+	const Vector2D<> drawPos = getDrawPos(can.getInterpolation());
+	can.draw(ms, static_cast<int>(drawPos.x), static_cast<int>(drawPos.y));
 	if (spell != nullptr)
 		spell->draw(can);
 }
@@ -117,6 +120,7 @@ void Player::mousePress() {
 	if (spell == nullptr) {
 		spell = GameData::instance().mgo->getSpellManager().newPlayerSpell(spellType);
 		updateSpellPos();
+		spell->savePrevPos();
 	}
 }
 
@@ -211,6 +215,7 @@ void Player::setSaveData(SaveData& data) const {
 void Player::getSaveData(const SaveData& data) {
 	entityPos.x = data.posX;
 	entityPos.y = data.posY;
+	savePrevPos();
 	entityHealth = data.health;
 	healthBar.refresh();
 }
@@ -60,7 +60,7 @@ private:
 
 	PlayerHealthBar healthBar;
 	MultistateSprite ms;
-	Spell* spell = nullptr;
+	Spell* spell = nullptr;	// from AttackManager, not added until released
 	SpellType spellType = SpellType::BASIC;
 	PlayerDirection direction = PlayerDirection::NONE;
 	Constants::float_type speed;	// max dist traveled in one direction per second
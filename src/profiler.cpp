@@ -0,0 +1,169 @@
+#include "profiler.h"
+#include "canvas.h"
+#include "color.h"
+#include "constants.h"
+#include "game_data.h"
+#include "resource_manager.h"
+#include "text_renderer.h"
+#include <algorithm>	// max, min
+#include <cmath>	// lround
+
+
+namespace ProfilerSettings {
+	constexpr int graphX = 4;
+	constexpr int graphY = Constants::RoomY + 4;
+	constexpr int graphHeight = 75;
+	constexpr float pixelsPerMS = 3.0f;	// graphHeight is 25 ms
+	constexpr int margin = 4;
+	constexpr int swatchSz = 8;
+	constexpr std::size_t legendRows = 5;
+	constexpr Color colBg = COLOR_BLACK;
+	constexpr Color colBudget = COLOR_WHITE;
+	constexpr Color colText = COLOR_WHITE;
+	constexpr Uint8 alphaBg = getAlpha<60>();
+	constexpr Uint8 alphaBudget = getAlpha<50>();
+	// indexed by Profiler::Zone
+	constexpr Color colZone[] = {
+		Color{255, 255, 255},	// EVENTS
+		Color{230, 60, 60},		// UPDATE_CM
+		Color{240, 150, 40},	// UPDATE_AM
+		Color{240, 230, 60},	// UPDATE_VFXM
+		Color{60, 180, 75},		// DRAW_ROOM
+		Color{70, 200, 200},	// DRAW_GI
+		Color{60, 110, 230},	// DRAW_PLAYER
+		Color{150, 80, 220},	// DRAW_MANAGERS
+		Color{230, 90, 200},	// PRESENT
+		Color{128, 128, 128}	// OTHER
+	};
+	constexpr const char* zoneNames[] = {
+		"events", "cm", "am", "vfxm", "room", "gi", "player", "managers", "present", "other"
+	};
+	static_assert(sizeof(colZone) / sizeof(colZone[0]) == Profiler::zoneCount, "missing zone color");
+	static_assert(sizeof(zoneNames) / sizeof(zoneNames[0]) == Profiler::zoneCount, "missing zone name");
+}
+
+
+constexpr std::size_t Profiler::zoneCount;
+constexpr std::size_t Profiler::historySize;
+std::array<Profiler::Sample, Profiler::historySize> Profiler::history{};
+std::array<Uint64, Profiler::zoneCount> Profiler::counts{};
+std::array<SDL_Texture*, Profiler::zoneCount> Profiler::legend{};
+std::array<SDL_Rect, Profiler::zoneCount> Profiler::legendRects{};
+std::size_t Profiler::next = 0;
+Uint64 Profiler::frameStart = 0;
+float Profiler::budget = 0;
+bool Profiler::enabled = false;
+
+
+void Profiler::beginFrame() {
+	if (enabled)
+		frameStart = SDL_GetPerformanceCounter();
+}
+
+
+// Store the zone times of the frame and start a new one
+void Profiler::endFrame() {
+	if (!enabled || (frameStart == 0)) {
+		counts.fill(0);
+		return;
+	}
+	const Uint64 total = SDL_GetPerformanceCounter() - frameStart;
+	const float msPerCount = 1000.0f / SDL_GetPerformanceFrequency();
+	Uint64 sum = 0;
+	for (std::size_t i = 0; i < zoneCount; ++i)
+		sum += counts[i];
+	counts[static_cast<std::size_t>(Zone::OTHER)] = (total > sum) ? (total - sum) : 0;
+	Sample& sample = history[next];
+	for (std::size_t i = 0; i < zoneCount; ++i)
+		sample[i] = counts[i] * msPerCount;
+	next = (next + 1) % historySize;
+	counts.fill(0);
+}
+
+
+// One column per frame, oldest on the left. The line marks the frame budget.
+void Profiler::draw(Canvas& can) {
+	using namespace ProfilerSettings;
+	if (!enabled)
+		return;
+	if (legend[0] == nullptr)
+		createLegend();
+	auto oldColor = can.getColorState();
+	const int bottom = graphY + graphHeight;
+	int legendWidth = 0;
+	int legendHeight = 0;
+	for (const SDL_Rect& r : legendRects) {
+		legendWidth = std::max(legendWidth, r.x + r.w);
+		legendHeight = std::max(legendHeight, r.y + r.h);
+	}
+	can.setColor(colBg, alphaBg);
+	can.fillRect(
+		graphX - margin, graphY - margin,
+		static_cast<int>(historySize) + legendWidth + (margin * 3), std::max(graphHeight, legendHeight) + (margin * 2)
+	);
+	for (std::size_t i = 0; i < historySize; ++i) {
+		const Sample& sample = history[(next + i) % historySize];
+		const int x = graphX + static_cast<int>(i);
+		int y = bottom;
+		for (std::size_t z = 0; (z < zoneCount) && (y > graphY); ++z) {
+			const int h = std::min(static_cast<int>(std::lround(sample[z] * pixelsPerMS)), y - graphY);
+			if (h <= 0)
+				continue;
+			y -= h;
+			can.setColor(colZone[z], SDL_ALPHA_OPAQUE);
+			can.fillRect(x, y, 1, h);
+		}
+	}
+	const int budgetY = bottom - static_cast<int>(std::lround(budget * 1000 * pixelsPerMS));
+	if (budgetY >= graphY) {
+		can.setColor(colBudget, alphaBudget);
+		can.fillRect(graphX, budgetY, static_cast<int>(historySize), 1);
+	}
+	// legend
+	const int legendX = graphX + static_cast<int>(historySize) + margin;
+	SDL_Rect dst;
+	for (std::size_t z = 0; z < zoneCount; ++z) {
+		dst = legendRects[z];
+		dst.x += legendX;
+		dst.y += graphY;
+		can.setColor(colZone[z], SDL_ALPHA_OPAQUE);
+		can.fillRect(dst.x - swatchSz - margin, dst.y + (dst.h - swatchSz) / 2, swatchSz, swatchSz);
+		if (legend[z] != nullptr)
+			can.draw(legend[z], &dst);
+	}
+	can.setColorState(oldColor);
+}
+
+
+void Profiler::freeResources() {
+	for (SDL_Texture*& tex : legend) {
+		SDL::freeNull(tex);
+		tex = nullptr;
+	}
+}
+
+
+// Render zone names, in columns of legendRows
+// legendRects are relative to the top left of the legend
+void Profiler::createLegend() {
+	using namespace ProfilerSettings;
+	TextRenderer* tr = GameData::instance().resources->getDefaultTR();
+	tr->setColor(colText);
+	const int rowHeight = std::max(tr->getMetrics().height, swatchSz);
+	int colX = swatchSz + margin;
+	int colWidth = 0;
+	for (std::size_t z = 0; z < zoneCount; ++z) {
+		if ((z > 0) && ((z % legendRows) == 0)) {
+			colX += colWidth + (margin * 2) + swatchSz;
+			colWidth = 0;
+		}
+		SDL_Surface* surf = tr->render(zoneNames[z]);
+		SDL_Rect& r = legendRects[z];
+		r.x = colX;
+		r.y = static_cast<int>(z % legendRows) * rowHeight;
+		r.w = surf->w;
+		r.h = surf->h;
+		colWidth = std::max(colWidth, r.w);
+		legend[z] = SDL::toTexture(surf);
+	}
+}
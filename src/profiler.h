@@ -0,0 +1,93 @@
+#pragma once
+
+#include "sdl_helper.h"
+#include <array>
+#include <cstddef>
+
+
+class Canvas;
+
+
+// CPU time spent per frame in parts of the game, measured with ProfileScope.
+// The last historySize frames are kept and drawn as a stacked frame-time graph.
+// Time not spent in any zone is shown as OTHER. Waiting for the next frame is
+//   not counted.
+class Profiler {
+public:
+	enum class Zone : std::size_t {
+		EVENTS=0, UPDATE_CM, UPDATE_AM, UPDATE_VFXM,
+		DRAW_ROOM, DRAW_GI, DRAW_PLAYER, DRAW_MANAGERS, PRESENT, OTHER, COUNT
+	};
+	static constexpr std::size_t zoneCount = static_cast<std::size_t>(Zone::COUNT);
+	static constexpr std::size_t historySize = 128;
+	typedef std::array<float, zoneCount> Sample;	// ms per zone
+
+	static void setEnabled(const bool);
+	static bool isEnabled(void);
+	static void setBudget(const float);	// frame budget in seconds
+	static void beginFrame(void);
+	static void endFrame(void);
+	static void add(const Zone, const Uint64);	// performance counter counts
+	static void draw(Canvas&);
+	static void freeResources(void);	// call before renderer is destroyed
+private:
+	static void createLegend(void);
+
+	static std::array<Sample, historySize> history;
+	static std::array<Uint64, zoneCount> counts;	// current frame
+	static std::array<SDL_Texture*, zoneCount> legend;
+	static std::array<SDL_Rect, zoneCount> legendRects;
+	static std::size_t next;	// next history index to write
+	static Uint64 frameStart;
+	static float budget;
+	static bool enabled;
+};
+
+
+// Add time from construction to destruction to a zone of the current frame
+class ProfileScope {
+	ProfileScope(const ProfileScope&) = delete;
+	void operator=(const ProfileScope&) = delete;
+public:
+	ProfileScope(const Profiler::Zone);
+	~ProfileScope();
+private:
+	Uint64 start;	// 0 if profiler is disabled
+	Profiler::Zone zone;
+};
+
+
+inline
+void Profiler::setEnabled(const bool b) {
+	enabled = b;
+}
+
+
+inline
+bool Profiler::isEnabled() {
+	return enabled;
+}
+
+
+inline
+void Profiler::setBudget(const float b) {
+	budget = b;
+}
+
+
+inline
+void Profiler::add(const Zone z, const Uint64 c) {
+	counts[static_cast<std::size_t>(z)] += c;
+}
+
+
+inline
+ProfileScope::ProfileScope(const Profiler::Zone z) : start(Profiler::isEnabled() ? SDL_GetPerformanceCounter() : 0), zone(z) {
+}
+
+
+inline
+ProfileScope::~ProfileScope() {
+	if (start != 0)
+		Profiler::add(zone, SDL_GetPerformanceCounter() - start);
+}
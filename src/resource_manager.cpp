@@ -8,10 +8,12 @@
 #include "font.h"
 #include "font_resource.h"
 #include "game_data.h"
+#include "glyph_atlas.h"
 #include "image.h"
 #include "logger.h"
 #include "sprite.h"
 #include "sprite_sheet.h"
+#include "trace.h"
 #include "utility.h"
 #include <boost/filesystem.hpp>
 #include <cstdint>	// uintptr_t
@@ -75,6 +77,8 @@ static std::string toString(const FontResource& fr) {
 
 ResourceManager::~ResourceManager() {
 	defaultTR.freeFont();
+	for (auto it = glyphAtlases.begin(); it != glyphAtlases.end(); ++it)
+		delete it->second;
 	for (auto it = fonts.begin(); it != fonts.end(); ++it)
 		TTF_CloseFont(it->second.res);
 	for (auto f : fontsPrivate)
@@ -85,7 +89,7 @@ ResourceManager::~ResourceManager() {
 		delete it->second.res;
 	for (auto it = images.begin(); it != images.end(); ++it) {
 		SDL::freeNull(it->second.res.surf);
-		SDL::freeNull(it->second.res.tex);
+		atlas.remove(it->second.res.tex);
 	}
 }
 
@@ -113,6 +117,7 @@ AnimatedSpriteSource* ResourceManager::loadAnimation(const rapidjson::Value& dat
 	assert(data.HasMember("name"));
 	assert(data.HasMember("img"));
 	assert(data.HasMember("type"));
+	TraceScope ts{"load animation", data["name"].GetString()};
 	auto it = animationLookup.find(data["type"].GetString());
 	if (it == animationLookup.end()) {
 		Logger::instance().exit(RuntimeError{
@@ -282,7 +287,7 @@ void ResourceManager::unloadFont(FontResource& fr) {
 #if defined(DEBUG_RM_UNLOAD_FONT) && DEBUG_RM_UNLOAD_FONT
 			DEBUG_BEGIN << DEBUG_RM_PREPEND << "unloadFont FREE (" << toString(fr) << ')' << std::endl;
 #endif
-			TTF_CloseFont(it->second.res);
+			closeFont(it->second.res);
 			fonts.erase(it);
 		}
 		else {
@@ -307,13 +312,25 @@ void ResourceManager::unloadFont(FontResource& fr) {
 #if defined(DEBUG_RM_UNLOAD_FONT) && DEBUG_RM_UNLOAD_FONT
 			DEBUG_BEGIN << DEBUG_RM_PREPEND << "unloadFont FREE (" << toString(fr) << ')' << std::endl;
 #endif
-			TTF_CloseFont(*it);
+			closeFont(*it);
 			fontsPrivate.erase(it);
 		}
 	}
 }
 
 
+GlyphAtlas* ResourceManager::getGlyphAtlas(const FontResource& fr) {
+	assert(fr.font != nullptr);
+	auto it = glyphAtlases.find(fr.font);
+	if (it != glyphAtlases.end())
+		return it->second;
+	TraceScope ts{"load glyph atlas", fr.name};
+	GlyphAtlas* ga = new GlyphAtlas(fr.font);
+	glyphAtlases.emplace(fr.font, ga);
+	return ga;
+}
+
+
 // surf=true when surface is needed, tex=true when texture is needed.
 // If it is only used to generate a surface, then only surf should be true.
 SpriteSheet* ResourceManager::getSpriteSheet(const std::string& name, const bool surf, const bool tex) {
@@ -323,7 +340,7 @@ SpriteSheet* ResourceManager::getSpriteSheet(const std::string& name, const bool
 		incSpriteSheetCounter(it->second, surf, tex);	// update sheet counter
 		// surface or texture may have been loaded, so update spritesheet
 		it->second.res->surf = ir->surf;
-		it->second.res->tex = ir->tex;
+		it->second.res->setTexture(ir->tex);
 		return it->second.res;
 	}
 	else {
@@ -350,7 +367,7 @@ void ResourceManager::freeSpriteSheet(const std::string& name, const bool surf,
 		}
 	}
 	if (it->second.countTex == 0) {
-		it->second.res->tex = nullptr;
+		it->second.res->setTexture(AtlasRegion{});
 		if (it->second.countSurf == 0) {
 			delSpriteSheet(sheets, it);
 		}
@@ -361,6 +378,7 @@ void ResourceManager::freeSpriteSheet(const std::string& name, const bool surf,
 std::shared_ptr<rapidjson::Document> ResourceManager::getRoomData(const int x, const int y) {
 	assert((x >= 0) && (y >= 0));
 	assert((x < Constants::MapCountX) && (y < Constants::MapCountY));
+	TraceScope ts{"load room", roomToString(x, y)};
 	std::string filePath = getPath(ResourceType::ROOM, roomToString(x, y));
 	std::shared_ptr<rapidjson::Document> data = JSONReader::read(filePath);
 	if (!data)
@@ -373,6 +391,7 @@ std::shared_ptr<rapidjson::Document> ResourceManager::getRoomData(const int x, c
 
 
 std::shared_ptr<rapidjson::Document> ResourceManager::getCreatureData(const std::string& name) {
+	TraceScope ts{"load creature", name};
 	std::string filePath = getPath(ResourceType::CREATURE, name);
 	std::shared_ptr<rapidjson::Document> data = JSONReader::read(filePath);
 	if (!data)
@@ -419,7 +438,8 @@ void ResourceManager::printResources(std::ostream& os) const {
 	for (auto it = images.cbegin(); it != images.cend(); ++it) {
 		os << '\t' << i << " name: " << q(it->first) << " countSurf: " << it->second.countSurf
 		   << " countTex: " << it->second.countTex << " SDL_Surface*: " << ptrToStr(it->second.res.surf)
-		   << " SDL_Texture*: " << ptrToStr(it->second.res.tex) << std::endl;
+		   << " SDL_Texture*: " << ptrToStr(it->second.res.tex.tex) << " rect: " << rectToStr(it->second.res.tex.rect)
+		   << std::endl;
 	}
 	os << std::endl;
 	// print animations
@@ -436,7 +456,8 @@ void ResourceManager::printResources(std::ostream& os) const {
 		os << '\t' << i << " name: " << q(it->first) << " countSurf: " << it->second.countSurf << " countTex: "
 		   << it->second.countTex << " SpriteSheet*: " << ptrToStr(it->second.res)
 		   << " imgName: " << q(it->second.res->imgName) << " surf: " << ptrToStr(it->second.res->surf)
-		   << " tex: " << ptrToStr(it->second.res->tex) << std::endl;
+		   << " tex: " << ptrToStr(it->second.res->tex) << " texPos: (" << it->second.res->texPos.x << ", "
+		   << it->second.res->texPos.y << ')' << std::endl;
 		os << "\t\tSPRITES ";
 		if (it->second.res->sprites.empty())
 			os << "empty!" << std::endl;
@@ -459,9 +480,9 @@ ResourceManager::ImageResource* ResourceManager::getImage(const std::string& nam
 			// need to load surface, either from texture or from disk
 			assert(false);	//! TODO not implemented
 		}
-		if (tex && (it->second.res.tex == nullptr)) {
+		if (tex && (it->second.res.tex.tex == nullptr)) {
 			assert(it->second.res.surf != nullptr);
-			it->second.res.tex = SDL::newTexture(it->second.res.surf);
+			it->second.res.tex = atlas.add(it->second.res.surf);
 		}
 		incImgCounter(it->second, surf, tex);
 		return &it->second.res;
@@ -475,6 +496,7 @@ ResourceManager::ImageResource* ResourceManager::getImage(const std::string& nam
 ResourceManager::ImageResource* ResourceManager::loadImage(const std::string& name, const bool surf, const bool tex) {
 	assert(images.find(name) == images.end());
 	assert(!(!surf && !tex));	// at least one should be true
+	TraceScope ts{"load image", name};
 	std::string path = getPath(ResourceType::IMAGE, name);
 	SDL_Surface* surface = SDL::loadBMP(path);
 	std::pair<bool, Color> colorKey = readColorKey(name);
@@ -492,13 +514,9 @@ ResourceManager::ImageResource* ResourceManager::loadImage(const std::string& na
 		ic.countSurf = 1;
 	}
 	if (tex) {
-		if (!surf) {
-			ic.res.tex = SDL::toTexture(surface);
-			ic.res.surf = nullptr;
-		}
-		else {
-			ic.res.tex = SDL::newTexture(surface);
-		}
+		ic.res.tex = atlas.add(surface);
+		if (!surf)
+			SDL::free(surface);
 		ic.countTex = 1;
 	}
 	auto p = images.insert(std::make_pair(name, ic));
@@ -510,6 +528,7 @@ ResourceManager::ImageResource* ResourceManager::loadImage(const std::string& na
 SpriteSheet* ResourceManager::loadSpriteSheet(const std::string& name, const bool surf, const bool tex) {
 	namespace rj = rapidjson;
 	assert(sheets.find(name) == sheets.end());	// the sheet must not be loaded already
+	TraceScope ts{"load spritesheet", name};
 	std::string filePath = getPath(ResourceType::SPRITE, name);
 	std::shared_ptr<rapidjson::Document> data = JSONReader::read(filePath);
 	if (!data)
@@ -533,7 +552,7 @@ SpriteSheet* ResourceManager::loadSpriteSheet(const std::string& name, const boo
 	}
 	ImageResource* const ir = getImage(ss->imgName, surf, tex);
 	ss->surf = ir->surf;
-	ss->tex = ir->tex;
+	ss->setTexture(ir->tex);
 	// insert into sheets
 	ImgCounter<SpriteSheet*> icSS;
 	icSS.res = ss;
@@ -552,8 +571,8 @@ AnimatedSpriteSource* ResourceManager::loadAnimationUni(const rapidjson::Value&
 	src->setImageName(data["img"].GetString());
 	int x, y, dx, dy, frames;
 	ImageResource* const ir = getImage(src->getImageName(), false, true);	// get texture
-	assert(ir->tex != nullptr);
-	src->setTexture(ir->tex);
+	assert(ir->tex.tex != nullptr);
+	src->setTexture(ir->tex.tex);
 	src->setDuration(static_cast<Constants::float_type>(data["dur"].GetUint()) / 1000);
 	src->setSize(data["w"].GetInt(), data["h"].GetInt());
 	x = data["x"].GetInt();
@@ -561,6 +580,9 @@ AnimatedSpriteSource* ResourceManager::loadAnimationUni(const rapidjson::Value&
 	dx = data["dx"].GetInt();
 	dy = data["dy"].GetInt();
 	frames = data["frames"].GetInt();
+	// frames are given in the image, offset them to the atlas
+	x += ir->tex.rect.x;
+	y += ir->tex.rect.y;
 	for (int i = 0; i < frames; ++i, x += dx, y += dy)
 		src->add(x, y);
 	return src;
@@ -594,18 +616,15 @@ bool ResourceManager::decImageCounter(ImgCounter<ImageResource>& ic, const bool
 	DEBUG_OS << "for " << q(ic.res.name) << std::endl;
 #endif // DEBUG_RM_IMG_REF
 	if (ic.countSurf == 0) {
-		SDL::free(ic.res.surf);
+		SDL::freeNull(ic.res.surf);
 		ic.res.surf = nullptr;
-		if (ic.countTex == 0)
-			return true;
 	}
 	if (ic.countTex == 0) {
-		SDL::free(ic.res.tex);
-		ic.res.tex = nullptr;
-		if (ic.countSurf == 0)
-			return true;
+		// frees the page space once nothing else on the page is used
+		atlas.remove(ic.res.tex);
+		ic.res.tex = AtlasRegion{};
 	}
-	return false;
+	return ((ic.countSurf == 0) && (ic.countTex == 0));
 }
 
 
@@ -644,11 +663,23 @@ void ResourceManager::decSpriteSheetCounter(ImgCounter<SpriteSheet*>& ic, const
 
 
 TTF_Font* ResourceManager::openFont(const Font& font) {
+	TraceScope ts{"load font", font.name};
 	std::string filePath = getPath(ResourceType::FONT, font.name);
 	return SDL::openFont(filePath, font.size);
 }
 
 
+// Close font and free its glyph atlas
+void ResourceManager::closeFont(TTF_Font* font) {
+	auto it = glyphAtlases.find(font);
+	if (it != glyphAtlases.end()) {
+		delete it->second;
+		glyphAtlases.erase(it);
+	}
+	TTF_CloseFont(font);
+}
+
+
 // NOTE: invalid color key will return false rather than throw exception
 // the only valid color key format is "r,g,b"
 std::pair<bool, Color> ResourceManager::readColorKey(const std::string& name) {
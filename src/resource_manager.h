@@ -4,6 +4,7 @@
 #include "json_reader.h"
 #include "sdl_helper.h"
 #include "text_renderer.h"
+#include "texture_atlas.h"
 #include <boost/functional/hash.hpp>
 #include <cassert>
 #include <cstddef>
@@ -22,6 +23,7 @@ class Entity;
 class EntityResource;
 enum class EntityResourceID : int;
 class FontResource;
+class GlyphAtlas;
 class Sprite;
 class SpriteSheet;
 class UniformAnimatedSpriteSource;
@@ -29,6 +31,8 @@ class UniformAnimatedSpriteSource;
 
 // Manage resources (images, fonts, animations, spritesheets)
 // When images are loaded, must specify if surface and/or texture is needed.
+// Image textures are packed into an atlas, so clip rects of sprites and
+//   animations are offset by where their image is in the atlas texture.
 class ResourceManager {
 	typedef unsigned int counter_type;
 	template<class T>
@@ -52,8 +56,8 @@ class ResourceManager {
 
 	struct ImageResource {
 		std::string name;
-		SDL_Surface* surf;
-		SDL_Texture* tex;
+		SDL_Surface* surf = nullptr;
+		AtlasRegion tex;	// tex.tex is nullptr if not loaded
 	};
 
 	template<class T>
@@ -99,6 +103,7 @@ public:
 	TextRenderer* getDefaultTR(void);
 	FontResource loadFont(const Font&, const bool=true);
 	void unloadFont(FontResource&);
+	GlyphAtlas* getGlyphAtlas(const FontResource&);	// valid until font is unloaded
 	// spritesheet
 	SpriteSheet* getSpriteSheet(const std::string&, const bool, const bool);
 	void freeSpriteSheet(const std::string&, const bool, const bool);
@@ -118,6 +123,7 @@ private:
 	void incSpriteSheetCounter(ImgCounter<SpriteSheet*>&, const bool, const bool);
 	void decSpriteSheetCounter(ImgCounter<SpriteSheet*>&, const bool, const bool);
 	TTF_Font* openFont(const Font&);
+	void closeFont(TTF_Font*);
 	static std::pair<bool, Color> readColorKey(const std::string&);
 	static void readColorKeyProc(Color&, const unsigned int, const int);
 	static std::string fontToString(const Font&);
@@ -126,6 +132,7 @@ private:
 	static std::string getPath(const ResourceType, const std::string&);
 
 	TextRenderer defaultTR;
+	TextureAtlas atlas;
 	std::unordered_map<Font, ResourceCounter<TTF_Font*>, FontHash> fonts;
 	std::unordered_map<std::string, AnimatedSpriteSource*> animations;
 	std::unordered_map<std::string, ImgCounter<ImageResource>> images;
@@ -133,4 +140,5 @@ private:
 	std::unordered_map<std::string, AnimationType> animationLookup;
 	std::unordered_map<int, ResourceCounter<EntityResource*>> entityResources;
 	std::unordered_set<TTF_Font*> fontsPrivate;
+	std::unordered_map<TTF_Font*, GlyphAtlas*> glyphAtlases;	// created when first requested
 };
@@ -5,10 +5,13 @@
 #include "game_data.h"
 #include "logger.h"
 #include "resource_manager.h"
+#include "room_cells.h"
 #include "sprite.h"
 #include "sprite_sheet.h"
+#include <algorithm>	// fill, max, max_element, min, min_element, sort
 #include <cassert>
 #include <cmath>
+#include <cstdint>	// int64_t
 
 
 namespace RoomConnHelper {
@@ -93,10 +96,93 @@ static void renderBgRepeat(Sprite& spr, SDL_Surface* dst, SDL_Rect& dstRect, int
 }
 
 
+// Time of a move, as a fraction of the whole move (num / den, den > 0)
+struct SweepTime {
+	int64_t num;
+	int64_t den;
+};
+
+
 inline
-static int sign(const int n) {
-	assert(n != 0);
-	return (n > 0 ? 1 : -1);
+static bool operator<(const SweepTime& a, const SweepTime& b) {
+	return ((a.num * b.den) < (b.num * a.den));
+}
+
+
+// cells are covered the same way as in the room backends
+using RoomCells::cellEnd;
+
+
+// Times a moving cell span [q0, q1) (moved by t * d) overlaps the cell span [b0, b1).
+// The overlap is the open interval (enter, exit).
+// If d is 0, the spans either always or never overlap.
+struct SweepAxis {
+	SweepTime enter;
+	SweepTime exit;
+	bool always;
+	bool never;
+};
+
+
+static SweepAxis sweepAxis(const int q0, const int q1, const int b0, const int b1, const int d) {
+	SweepAxis s;
+	s.always = false;
+	s.never = false;
+	if (d == 0) {
+		s.always = ((q0 < b1) && (q1 > b0));
+		s.never = !s.always;
+	}
+	else if (d > 0) {
+		s.enter = SweepTime{b0 - q1, d};
+		s.exit = SweepTime{b1 - q0, d};
+	}
+	else {
+		s.enter = SweepTime{q0 - b1, -d};
+		s.exit = SweepTime{q1 - b0, -d};
+	}
+	return s;
+}
+
+
+// Change of integer position when moving from pos to newPos
+static IntPair intDelta(const Vector2D<>& pos, const Vector2D<>& newPos) {
+	return IntPair{
+		static_cast<int>(newPos.x) - static_cast<int>(pos.x),
+		static_cast<int>(newPos.y) - static_cast<int>(pos.y)
+	};
+}
+
+
+// Position after moving by moved instead of the wanted delta, keeps the fractional
+//   part of newPos on axes that moved the full distance
+static Vector2D<> movedPos(const Vector2D<>& pos, const Vector2D<>& newPos, const IntPair& delta, const IntPair& moved) {
+	typedef Vector2D<>::underlying_type T;
+	return Vector2D<>{
+		(delta.first == moved.first) ? newPos.x : (pos.x + static_cast<T>(moved.first)),
+		(delta.second == moved.second) ? newPos.y : (pos.y + static_cast<T>(moved.second))
+	};
+}
+
+
+// Rect covering rect before and after moving by delta
+static SDL_Rect sweepArea(const SDL_Rect& rect, const IntPair& delta) {
+	SDL_Rect area;
+	area.x = rect.x + std::min(delta.first, 0);
+	area.y = rect.y + std::min(delta.second, 0);
+	area.w = rect.w + std::abs(delta.first);
+	area.h = rect.h + std::abs(delta.second);
+	return area;
+}
+
+
+// Fill order with indices of rects, sorted top to bottom, then left to right
+static void sortByPos(const std::vector<SDL_Rect>& rects, std::vector<std::size_t>& order) {
+	order.resize(rects.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&rects](const std::size_t a, const std::size_t b) {
+		return (rects[a].y < rects[b].y) || ((rects[a].y == rects[b].y) && (rects[a].x < rects[b].x));
+	});
 }
 
 } // namespace RoomHelper
@@ -209,6 +295,7 @@ void RoomConnections::render() {
 					}
 				}
 			}
+			SDL::freeNull(p.tex);
 			p.tex = SDL::toTexture(surf);
 		}
 	}
@@ -286,26 +373,22 @@ void Room::set(rapidjson::Document& data) {
 	assert(room == nullptr);
 	// setup RoomStruct defaults
 	room = new RoomStruct;
+	candidatesValid = false;
 	room->block.setBounds(Rectangle{
-		// block is 1 pixel longer on each side to add 4 block rects
-		// to surround drawRect
+		// block is 1 pixel longer on each side, so entities can reach the
+		// edges of drawRect (the space outside of block is blocked)
 		Constants::RoomX - 1,
 		Constants::RoomY - 1,
 		Constants::roomWidth + 2,
 		Constants::roomHeight + 2
 	});
-	// add rectangles around edges of block
-	const auto& bounds = room->block.getBounds();
-	test.resize(bounds.width(), 1);
-	test.move(bounds.getX(), bounds.getY());
-	room->block.insert(test);	// top
-	test.move(test.getX(), test.getY() + bounds.height() - 1);
-	room->block.insert(test);	// bottom
-	test.resize(1, bounds.height());
-	test.move(bounds.getX(), bounds.getY());
-	room->block.insert(test);	// left
-	test.move(test.getX() + bounds.width() - 1, test.getY());
-	room->block.insert(test);	// right
+	{	// add 1 cell rectangles just outside block bounds, for sweeping
+		const Rectangle& b = room->block.getBounds();
+		addSweepRect(Rectangle{b.getX() - 1, b.getY() - 1, b.width() + 2, 1});	// top
+		addSweepRect(Rectangle{b.getX() - 1, b.getY() + b.height() - 1, b.width() + 2, 1});	// bottom
+		addSweepRect(Rectangle{b.getX() - 1, b.getY() - 1, 1, b.height() + 2});	// left
+		addSweepRect(Rectangle{b.getX() + b.width() - 1, b.getY() - 1, 1, b.height() + 2});	// right
+	}
 	{	// process block data
 		SDL_Rect tmpRect;
 		const rj::Value& block = data["block"];
@@ -314,8 +397,10 @@ void Room::set(rapidjson::Document& data) {
 			JSONHelper::readRect(tmpRect, it2);
 			test.resize(tmpRect.w, tmpRect.h);
 			test.move(Constants::RoomX + tmpRect.x, Constants::RoomY + tmpRect.y);
-			room->block.insert(test);
+			addBlockRect(test);
 		}
+		room->block.build();
+		buildSweepGrid();
 	}
 	// set background image
 	room->bgSurf = renderBg(data["background"]);
@@ -335,69 +420,138 @@ bool Room::space(const SDL_Rect& r) const {
 }
 
 
+// Pixels outside of room bounds are blocked
+int Room::blocked(const SDL_Rect& r) const {
+	return room->block.count(r);
+}
+
+
+// Query several rects at once, result[i] is space(rects[i])
+// Rects are queried in order of position, so nearby queries touch the same block data.
+void Room::spaceBatch(const std::vector<SDL_Rect>& rects, std::vector<bool>& result) const {
+	std::vector<std::size_t> order;
+	RoomHelper::sortByPos(rects, order);
+	result.resize(rects.size());
+	for (const std::size_t i : order)
+		result[i] = !room->block.collides(rects[i]);
+}
+
+
 // Attempt to move entity by deltaPos, or as close to it as possible.
 void Room::update(GameEntity& entity, const Vector2D<>& deltaPos) {
-	SDL_Rect entityBounds = entity.getBounds();
-	Vector2D<> entityPos = entity.getPos();
-	Vector2D<> newPos{entityPos.x + deltaPos.x, entityPos.y + deltaPos.y};
-	Vector2D<> actualNewPos;
-	const IntPair deltaPosInt{
-		static_cast<int>(newPos.x) - static_cast<int>(entityPos.x),
-		static_cast<int>(newPos.y) - static_cast<int>(entityPos.y)
-	};
-	IntPair newDeltaPosInt{0, 0};	// default value
-	if (deltaPosInt.first == 0) {
-		if (deltaPosInt.second == 0) {
-			// Since integer position has not changed, this position change is always allowed
-			entity.setPos(newPos);
-			return;
-		}
-		else {
-			newDeltaPosInt.second = updateVert(entityBounds, deltaPosInt.second);
+	using namespace RoomHelper;
+	const Vector2D<> entityPos = entity.getPos();
+	const Vector2D<> newPos{entityPos.x + deltaPos.x, entityPos.y + deltaPos.y};
+	const IntPair deltaPosInt = intDelta(entityPos, newPos);
+	if ((deltaPosInt.first == 0) && (deltaPosInt.second == 0)) {
+		// Since integer position has not changed, this position change is always allowed
+		entity.setPos(newPos);
+		return;
+	}
+	const IntPair newDeltaPosInt = sweep(entity.getBounds(), deltaPosInt);
+	entity.setPos(movedPos(entityPos, newPos, deltaPosInt, newDeltaPosInt));
+}
+
+
+// Same as calling update() for each move, entities should not overlap each other's
+//   path since they are not checked against each other.
+// Moves are resolved in order of position, so the block rects found for a blocked
+//   move are usually reused by the moves after it (see sweep()).
+void Room::updateBatch(const std::vector<RoomMove>& moves) {
+	using namespace RoomHelper;
+	batch.clear();
+	for (std::size_t i = 0; i < moves.size(); ++i) {
+		const RoomMove& m = moves[i];
+		const Vector2D<> entityPos = m.entity->getPos();
+		const IntPair deltaPosInt = intDelta(entityPos, entityPos + m.delta);
+		if ((deltaPosInt.first == 0) && (deltaPosInt.second == 0)) {
+			m.entity->setPos(entityPos + m.delta);
+			continue;
 		}
+		BatchMove bm;
+		bm.bounds = m.entity->getBounds();
+		bm.area = sweepArea(bm.bounds, deltaPosInt);
+		bm.delta = deltaPosInt;
+		bm.index = i;
+		batch.push_back(bm);
 	}
-	else if (deltaPosInt.second == 0) {
-		newDeltaPosInt.first = updateHoriz(entityBounds, deltaPosInt.first);
+	std::sort(batch.begin(), batch.end(), [](const BatchMove& a, const BatchMove& b) {
+		return (a.area.y < b.area.y) || ((a.area.y == b.area.y) && (a.area.x < b.area.x));
+	});
+	for (const BatchMove& bm : batch) {
+		const RoomMove& m = moves[bm.index];
+		const Vector2D<> entityPos = m.entity->getPos();
+		const IntPair moved = sweep(bm.bounds, bm.delta);
+		m.entity->setPos(movedPos(entityPos, entityPos + m.delta, bm.delta, moved));
 	}
-	else if ((std::abs(deltaPosInt.first) > 1) || (std::abs(deltaPosInt.second) > 1)) {
-		newDeltaPosInt = updateDiag(entityBounds, deltaPosInt);
-		if (newDeltaPosInt.first == 0) {
-			if (newDeltaPosInt.second == 0) {
-				// Most likely entity walking into a block rect, attempt to move
-				//   in line in each direction, since there may still be room.
-				newDeltaPosInt.first = updateHoriz(entityBounds, deltaPosInt.first);
-				newDeltaPosInt.second = updateVert(entityBounds, deltaPosInt.second);
-			}
-			else {
-				// If one direction moves a little, and the other none, then
-				//   most likely running into a block rect where updateDiag()
-				//   returns after the first step. Continue trying to move
-				//   in the direction in which step was taken.
-				entityBounds.y += newDeltaPosInt.second;
-				if ((deltaPosInt.second - newDeltaPosInt.second) != 0) {
-					newDeltaPosInt.second += updateVert(entityBounds, deltaPosInt.second - newDeltaPosInt.second);
-				}
-			}
-		}
-		else if (newDeltaPosInt.second == 0) {
-			entityBounds.x += newDeltaPosInt.first;
-			if ((deltaPosInt.first - newDeltaPosInt.first) != 0) {
-				newDeltaPosInt.first += updateHoriz(entityBounds, deltaPosInt.first - newDeltaPosInt.first);
-			}
+}
+
+
+void Room::addBlockRect(const Rectangle& r) {
+	room->block.insert(r);
+	addSweepRect(r);
+}
+
+
+void Room::addSweepRect(const Rectangle& r) {
+	using RoomHelper::cellEnd;
+	RoomBlockRects& br = room->blockRects;
+	br.x0.push_back(r.getX());
+	br.y0.push_back(r.getY());
+	br.x1.push_back(cellEnd(r.getX(), r.width()));
+	br.y1.push_back(cellEnd(r.getY(), r.height()));
+}
+
+
+// Index block rects by the grid cells they cover, call after adding all of them
+void Room::buildSweepGrid() {
+	using namespace Constants;
+	RoomBlockRects& br = room->blockRects;
+	assert(!br.x0.empty());
+	const int maxX = *std::max_element(br.x1.begin(), br.x1.end());
+	const int maxY = *std::max_element(br.y1.begin(), br.y1.end());
+	br.originX = *std::min_element(br.x0.begin(), br.x0.end());
+	br.originY = *std::min_element(br.y0.begin(), br.y0.end());
+	br.cellsX = ((maxX - br.originX) / RoomSweepCellSz) + 1;
+	br.cellsY = ((maxY - br.originY) / RoomSweepCellSz) + 1;
+	const std::size_t cellCount = static_cast<std::size_t>(br.cellsX * br.cellsY);
+	// count rects of each cell, then place them after the rects of earlier cells
+	br.cellStart.assign(cellCount + 1, 0);
+	for (std::size_t i = 0; i < br.x0.size(); ++i) {
+		const CellRange r = toCellRange(br.x0[i], br.y0[i], br.x1[i], br.y1[i]);
+		for (int y = r.y0; y <= r.y1; ++y) {
+			for (int x = r.x0; x <= r.x1; ++x)
+				++br.cellStart[static_cast<std::size_t>((y * br.cellsX) + x + 1)];
 		}
 	}
-	else {
-		newDeltaPosInt = updateStep(entityBounds, deltaPosInt);
+	for (std::size_t c = 1; c <= cellCount; ++c)
+		br.cellStart[c] += br.cellStart[c - 1];
+	br.cellRects.resize(br.cellStart[cellCount]);
+	std::vector<uint32_t> next(br.cellStart.begin(), br.cellStart.end() - 1);
+	for (std::size_t i = 0; i < br.x0.size(); ++i) {
+		const CellRange r = toCellRange(br.x0[i], br.y0[i], br.x1[i], br.y1[i]);
+		for (int y = r.y0; y <= r.y1; ++y) {
+			for (int x = r.x0; x <= r.x1; ++x)
+				br.cellRects[next[static_cast<std::size_t>((y * br.cellsX) + x)]++] = static_cast<uint32_t>(i);
+		}
 	}
-	if (deltaPosInt.first == newDeltaPosInt.first)
-		actualNewPos.x = newPos.x;
-	else
-		actualNewPos.x = (entityPos.x + static_cast<decltype(entityPos.x)>(newDeltaPosInt.first));
-	if (deltaPosInt.second == newDeltaPosInt.second)
-		actualNewPos.y = newPos.y;
-	else
-		actualNewPos.y = (entityPos.y + static_cast<decltype(entityPos.y)>(newDeltaPosInt.second));
-	entity.setPos(actualNewPos);
+	blockStamps.assign(br.x0.size(), 0);
+	stamp = 0;
+}
+
+
+// Grid cells holding the room cells [x0, x1) x [y0, y1), clamped to the grid
+Room::CellRange Room::toCellRange(const int x0, const int y0, const int x1, const int y1) const {
+	const RoomBlockRects& br = room->blockRects;
+	auto toCell = [](const int pos, const int count) {
+		return std::min(std::max(pos / Constants::RoomSweepCellSz, 0), count - 1);
+	};
+	return CellRange{
+		toCell(x0 - br.originX, br.cellsX),
+		toCell(y0 - br.originY, br.cellsY),
+		toCell(x1 - 1 - br.originX, br.cellsX),
+		toCell(y1 - 1 - br.originY, br.cellsY)
+	};
 }
 
 
@@ -440,138 +594,138 @@ SDL_Surface* Room::renderBg(const rapidjson::Value& data) {
 }
 
 
-IntPair Room::updateStep(const SDL_Rect& rect, const IntPair& delta) {
-	assert(std::abs(delta.first) == 1);
-	assert(std::abs(delta.second) == 1);
-	SDL_Rect newRect = rect;
-	const int signX = RoomHelper::sign(delta.first);
-	const int signY = RoomHelper::sign(delta.second);
-	IntPair newDelta{0, 0};
-	newRect.x += signX;
-	if (space(newRect)) {
-		newDelta.first += signX;
-		newRect.y += signY;
-		if (space(newRect))
-			newDelta.second += signY;
+// Move rect by delta, or as far along the line to it as possible, then slide
+//   along the face that was hit for the rest of the move.
+// If the area covering the whole move is empty (the usual case) this is a
+//   single query, otherwise the time of impact is computed from the block rects
+//   in that area.
+IntPair Room::sweep(const SDL_Rect& rect, const IntPair& delta) {
+	const SDL_Rect area = RoomHelper::sweepArea(rect, delta);
+	if (space(area))
+		return delta;
+	// the slide stays inside area, so this is all that can be hit
+	findBlockRects(area);
+	SweepHit hit;
+	IntPair moved = sweepLine(rect, delta, hit);
+	if (hit == SweepHit::NONE)
+		return moved;
+	SDL_Rect slideRect = rect;
+	slideRect.x += moved.first;
+	slideRect.y += moved.second;
+	SweepHit slideHit;
+	if ((hit != SweepHit::X) && (delta.first != moved.first)) {
+		// slide horizontally
+		const int dx = sweepLine(slideRect, IntPair{delta.first - moved.first, 0}, slideHit).first;
+		moved.first += dx;
+		slideRect.x += dx;
 	}
-	else {
-		newRect.x = rect.x;	// reset
-		newRect.y += signY;
-		if (space(newRect)) {
-			newDelta.second += signY;
-			newRect.x += signX;
-			if (space(newRect))
-				newDelta.first += signX;
-		}
+	if ((hit != SweepHit::Y) && (delta.second != moved.second)) {
+		// slide vertically
+		moved.second += sweepLine(slideRect, IntPair{0, delta.second - moved.second}, slideHit).second;
 	}
-	return newDelta;
+	return moved;
 }
 
 
-int Room::updateHoriz(const SDL_Rect& rect, const int delta) {
-	assert(delta != 0);
-	SDL_Rect newRect = rect;
-	const int sign = RoomHelper::sign(delta);
-	newRect.x += sign;
-	const int countEnd = std::abs(delta);
-	int count;
-	for (count = 0; count < countEnd; ++count, newRect.x += sign) {
-		if (!space(newRect))
-			break;
+// Set candidates to the block rects in the grid cells of area, which includes
+//   every rect overlapping it.
+// Rects are found for 1 more cell around area and kept until an area outside of
+//   those cells is asked for, so moves near each other share them. Extra rects
+//   never stop a move, they are just tested for nothing.
+void Room::findBlockRects(const SDL_Rect& area) {
+	using RoomHelper::cellEnd;
+	const RoomBlockRects& br = room->blockRects;
+	const CellRange cells = toCellRange(area.x, area.y, cellEnd(area.x, area.w), cellEnd(area.y, area.h));
+	if (candidatesValid && candidateCells.contains(cells))
+		return;
+	candidateCells = CellRange{
+		std::max(cells.x0 - 1, 0),
+		std::max(cells.y0 - 1, 0),
+		std::min(cells.x1 + 1, br.cellsX - 1),
+		std::min(cells.y1 + 1, br.cellsY - 1)
+	};
+	candidatesValid = true;
+	// a rect in several cells is only added once, found by its stamp
+	if (++stamp == 0) {
+		std::fill(blockStamps.begin(), blockStamps.end(), 0);
+		stamp = 1;
+	}
+	candidates.clear();
+	for (int y = candidateCells.y0; y <= candidateCells.y1; ++y) {
+		for (int x = candidateCells.x0; x <= candidateCells.x1; ++x) {
+			const std::size_t c = static_cast<std::size_t>((y * br.cellsX) + x);
+			for (uint32_t j = br.cellStart[c]; j < br.cellStart[c + 1]; ++j) {
+				const uint32_t i = br.cellRects[j];
+				if (blockStamps[i] != stamp) {
+					blockStamps[i] = stamp;
+					candidates.push_back(i);
+				}
+			}
+		}
 	}
-	return (count * sign);
 }
 
 
-int Room::updateVert(const SDL_Rect& rect, const int delta) {
-	assert(delta != 0);
-	SDL_Rect newRect = rect;
-	const int sign = RoomHelper::sign(delta);
-	newRect.y += sign;
-	const int countEnd = std::abs(delta);
-	int count;
-	for (count = 0; count < countEnd; ++count, newRect.y += sign) {
-		if (!space(newRect))
-			break;
-	}
-	return (count * sign);
-}
-
-
-// use Bresenham's line algorithm with modification that diagonals
-//   take additional step
-//   (as in, going from (0,0) to (1,1) must also visit (0,1) or (1,0))
-IntPair Room::updateDiag(const SDL_Rect& rect, const IntPair& delta) {
-	assert(delta.first != 0);
-	assert(delta.second != 0);
-	if (std::abs(delta.first) >= std::abs(delta.second))
-		return updateDiagX(rect, delta);
-	else
-		return updateDiagY(rect, delta);
-}
-
-
-IntPair Room::updateDiagX(const SDL_Rect& rect, const IntPair& delta) {
-	SDL_Rect newRect = rect;
-	IntPair newDelta{0, 0};
-	const int countEnd = std::abs(delta.first);
-	const int signX = RoomHelper::sign(delta.first);
-	const int signY = RoomHelper::sign(delta.second);
-	newRect.x += signX;
-	int D = ((2 * delta.second * signY) - delta.first * signX);
-	for (int count = 0; count < countEnd; ++count, newRect.x += signX) {
-		if (D > 0) {
-			if (space(newRect))
-				newDelta.first += signX;
-			else
-				break;
-			newRect.y += signY;
-			if (space(newRect))
-				newDelta.second += signY;
-			else
-				break;
-			D += (2 * ((delta.second * signY) - (delta.first * signX)));
-		}
-		else {
-			if (space(newRect))
-				newDelta.first += signX;
-			else
-				break;
-			D += (2 * delta.second * signY);
+// Move rect along the line to delta until it would hit one of candidates.
+// The result is truncated towards the start, which never collides when the line
+//   up to the time of impact doesn't, since block rects have integer coordinates.
+IntPair Room::sweepLine(const SDL_Rect& rect, const IntPair& delta, SweepHit& hit) const {
+	using namespace RoomHelper;
+	const RoomBlockRects& br = room->blockRects;
+	const int qx0 = rect.x;
+	const int qy0 = rect.y;
+	const int qx1 = cellEnd(rect.x, rect.w);
+	const int qy1 = cellEnd(rect.y, rect.h);
+	SweepTime first{1, 1};	// earliest impact
+	hit = SweepHit::NONE;
+	for (const uint32_t i : candidates) {
+		const SweepAxis ax = sweepAxis(qx0, qx1, br.x0[i], br.x1[i], delta.first);
+		if (ax.never)
+			continue;
+		const SweepAxis ay = sweepAxis(qy0, qy1, br.y0[i], br.y1[i], delta.second);
+		if (ay.never)
+			continue;
+		// interval during which both axes overlap
+		SweepTime enter{0, 1};
+		SweepTime exit{1, 1};
+		SweepHit side = SweepHit::CORNER;
+		if (ax.always) {
+			enter = ay.enter;
+			exit = ay.exit;
+			side = SweepHit::Y;
 		}
-	}
-	return newDelta;
-}
-
-
-IntPair Room::updateDiagY(const SDL_Rect& rect, const IntPair& delta) {
-	SDL_Rect newRect = rect;
-	IntPair newDelta{0, 0};
-	const int countEnd = std::abs(delta.second);
-	const int signX = RoomHelper::sign(delta.first);
-	const int signY = RoomHelper::sign(delta.second);
-	newRect.y += signY;
-	int D = ((2 * delta.first * signX) - delta.second * signY);
-	for (int count = 0; count < countEnd; ++count, newRect.y += signY) {
-		if (D > 0) {
-			if (space(newRect))
-				newDelta.second += signY;
-			else
-				break;
-			newRect.x += signX;
-			if (space(newRect))
-				newDelta.first += signX;
-			else
-				break;
-			D += (2 * ((delta.first * signX) - (delta.second * signY)));
+		else if (ay.always) {
+			enter = ax.enter;
+			exit = ax.exit;
+			side = SweepHit::X;
 		}
 		else {
-			if (space(newRect))
-				newDelta.second += signY;
-			else
-				break;
-			D += (2 * delta.first * signX);
+			if (ay.enter < ax.enter) {
+				enter = ax.enter;
+				side = SweepHit::X;
+			}
+			else if (ax.enter < ay.enter) {
+				enter = ay.enter;
+				side = SweepHit::Y;
+			}
+			else {
+				enter = ax.enter;
+			}
+			exit = (ax.exit < ay.exit) ? ax.exit : ay.exit;
+		}
+		if (!(enter < exit) || !(enter < SweepTime{1, 1}) || (exit.num <= 0))
+			continue;	// no overlap during move
+		if (enter.num < 0)
+			enter = SweepTime{0, 1};	// already overlapping
+		if (enter < first) {
+			first = enter;
+			hit = side;
 		}
 	}
-	return newDelta;
+	if (hit == SweepHit::NONE)
+		return delta;
+	return IntPair{
+		static_cast<int>((delta.first * first.num) / first.den),
+		static_cast<int>((delta.second * first.num) / first.den)
+	};
 }
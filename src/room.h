@@ -1,14 +1,28 @@
 #pragma once
 
 #include "json_reader.h"
+#include "constants.h"
+#include "room_bitmap.h"
 #include "room_inc.h"
 #include "room_qtree.h"
+#include "room_sat.h"
 #include "sdl_helper.h"
 #include "shapes.h"
 #include "utility_struct.h"
+#include <cstdint>
+#include <type_traits>	// conditional
 #include <vector>
 
 
+// Collision backend of block rects, selected by Constants::RoomBlock
+typedef std::conditional<
+	Constants::RoomBlock == Constants::RoomBlockType::SAT, SATRoom,
+	std::conditional<
+		Constants::RoomBlock == Constants::RoomBlockType::BITMAP, BitmapRoom, QuadtreeRoom
+	>::type
+>::type RoomBlock;
+
+
 class GameEntity;
 class SpriteSheet;
 
@@ -22,7 +36,7 @@ struct RoomConnSpriteData {
 
 struct RoomConnection {
 	IntPair pos;
-	SDL_Texture* tex = nullptr;
+	SDL_Texture* tex = nullptr;	// own texture, rendered per room so kept out of the atlas
 };
 
 
@@ -44,19 +58,64 @@ private:
 };
 
 
+// Block rects as cells [x0, x1) x [y0, y1), stored by coordinate for the sweep
+// Includes 4 rects around block bounds
+// Rects are indexed by a coarse grid of RoomSweepCellSz cells over all of them,
+//   the rects of cell c are cellRects[cellStart[c], cellStart[c + 1]).
+struct RoomBlockRects {
+	std::vector<int> x0;
+	std::vector<int> y0;
+	std::vector<int> x1;
+	std::vector<int> y1;
+	std::vector<uint32_t> cellStart;
+	std::vector<uint32_t> cellRects;
+	int originX = 0;
+	int originY = 0;
+	int cellsX = 0;
+	int cellsY = 0;
+};
+
+
 struct RoomStruct {
 	~RoomStruct();
 
 	RoomConnections connections;
-	QuadtreeRoom block;
+	RoomBlock block;
+	RoomBlockRects blockRects;
 	SDL_Surface* bgSurf = nullptr;
 	SDL_Texture* bgTex = nullptr;
 };
 
 
+// An entity and how far it wants to move
+struct RoomMove {
+	GameEntity* entity;
+	Vector2D<> delta;
+};
+
+
 class Room {
 	Room(const Room&) = delete;
 	void operator=(const Room&) = delete;
+	// axis of the face hit when sweeping, CORNER if both at once
+	enum class SweepHit {NONE, X, Y, CORNER};
+
+	// inclusive range of grid cells of RoomBlockRects
+	struct CellRange {
+		bool contains(const CellRange&) const;
+
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+	};
+
+	struct BatchMove {
+		SDL_Rect bounds;
+		SDL_Rect area;	// covers bounds before and after move
+		IntPair delta;
+		std::size_t index;	// into moves
+	};
 public:
 	Room();
 	~Room();
@@ -64,21 +123,37 @@ public:
 	void set(rapidjson::Document&);
 	bool space(const int, const int, const int, const int) const;
 	bool space(const SDL_Rect&) const;
+	int blocked(const SDL_Rect&) const;	// number of blocked pixels
+	void spaceBatch(const std::vector<SDL_Rect>&, std::vector<bool>&) const;
 	void updateEntity(GameEntity&, const int, const int) const;
 	void update(GameEntity&, const Vector2D<>&);
+	void updateBatch(const std::vector<RoomMove>&);
 	void notifyClear(void);	// room has been cleared
 private:
 	SDL_Surface* renderBg(const rapidjson::Value&);
-	int updateHoriz(const SDL_Rect&, const int);
-	int updateVert(const SDL_Rect&, const int);
-	IntPair updateStep(const SDL_Rect&, const IntPair&);
-	IntPair updateDiag(const SDL_Rect&, const IntPair&);
-	IntPair updateDiagX(const SDL_Rect&, const IntPair&);
-	IntPair updateDiagY(const SDL_Rect&, const IntPair&);
+	void addBlockRect(const Rectangle&);
+	void addSweepRect(const Rectangle&);
+	void buildSweepGrid(void);
+	CellRange toCellRange(const int, const int, const int, const int) const;
+	void findBlockRects(const SDL_Rect&);
+	IntPair sweep(const SDL_Rect&, const IntPair&);
+	IntPair sweepLine(const SDL_Rect&, const IntPair&, SweepHit&) const;
 
 	RoomStruct* room = nullptr;
 	RoomConnSpriteData sprData;
 	SDL_Rect drawRect;
 	mutable Rectangle test;
+	std::vector<uint32_t> blockStamps;	// per block rect, used by findBlockRects()
+	uint32_t stamp = 0;
+	std::vector<uint32_t> candidates;	// block rects that may be hit by sweep
+	CellRange candidateCells;	// cells candidates were found in
+	bool candidatesValid = false;
+	std::vector<BatchMove> batch;
 	bool cleared = false;
 };
+
+
+inline
+bool Room::CellRange::contains(const CellRange& r) const {
+	return ((r.x0 >= x0) && (r.y0 >= y0) && (r.x1 <= x1) && (r.y1 <= y1));
+}
@@ -0,0 +1,125 @@
+#include "room_bitmap.h"
+#include "room_cells.h"
+#include <algorithm>	// fill, max, min
+#include <cassert>
+#ifndef NDEBUG
+
+
+void BitmapRoom::draw(Canvas& can) {
+	RoomCells::draw(can, bounds, [this](const int x, const int y) {
+		const word_type* row = &bits[static_cast<std::size_t>(y * wordsPerRow)];
+		return (((row[x / wordBits] >> (x % wordBits)) & 1) != 0);
+	});
+}
+
+#endif // NDEBUG
+
+
+void BitmapRoom::setBounds(const Rectangle& r) {
+	assert((r.width() > 1) && (r.height() > 1));
+	bounds = r;
+	cellsX = bounds.width() - 1;
+	cellsY = bounds.height() - 1;
+	wordsPerRow = (cellsX + wordBits - 1) / wordBits;
+	bits.assign(static_cast<std::size_t>(wordsPerRow * cellsY), 0);
+}
+
+
+// only the part of rect inside bounds is stored
+void BitmapRoom::insert(const Rectangle& r) {
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, cellsX - 1);
+	y1 = std::min(y1, cellsY - 1);
+	if ((x0 > x1) || (y0 > y1))
+		return;
+	const int w0 = x0 / wordBits;
+	const int w1 = x1 / wordBits;
+	for (int y = y0; y <= y1; ++y) {
+		word_type* row = &bits[static_cast<std::size_t>(y * wordsPerRow)];
+		if (w0 == w1) {
+			row[w0] |= (maskFrom(x0 % wordBits) & maskTo(x1 % wordBits));
+			continue;
+		}
+		row[w0] |= maskFrom(x0 % wordBits);
+		for (int w = w0 + 1; w < w1; ++w)
+			row[w] = ~word_type{0};
+		row[w1] |= maskTo(x1 % wordBits);
+	}
+}
+
+
+// does the given rect collide with any block rects or leave bounds?
+bool BitmapRoom::collides(const Rectangle& r) const {
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	if ((x0 < 0) || (y0 < 0) || (x1 >= cellsX) || (y1 >= cellsY))
+		return true;
+	const int w0 = x0 / wordBits;
+	const int w1 = x1 / wordBits;
+	const word_type first = maskFrom(x0 % wordBits);
+	const word_type last = maskTo(x1 % wordBits);
+	if (w0 == w1) {
+		const word_type mask = (first & last);
+		for (int y = y0; y <= y1; ++y) {
+			if (bits[static_cast<std::size_t>((y * wordsPerRow) + w0)] & mask)
+				return true;
+		}
+		return false;
+	}
+	for (int y = y0; y <= y1; ++y) {
+		const word_type* row = &bits[static_cast<std::size_t>(y * wordsPerRow)];
+		if ((row[w0] & first) || (row[w1] & last))
+			return true;
+		for (int w = w0 + 1; w < w1; ++w) {
+			if (row[w] != 0)
+				return true;
+		}
+	}
+	return false;
+}
+
+
+// Number of blocked cells in rect, cells outside of bounds are blocked
+int BitmapRoom::count(const Rectangle& r) const {
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	const int area = (x1 - x0 + 1) * (y1 - y0 + 1);
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, cellsX - 1);
+	y1 = std::min(y1, cellsY - 1);
+	if ((x0 > x1) || (y0 > y1))
+		return area;
+	int blocked = area - ((x1 - x0 + 1) * (y1 - y0 + 1));
+	const int w0 = x0 / wordBits;
+	const int w1 = x1 / wordBits;
+	const word_type first = maskFrom(x0 % wordBits);
+	const word_type last = maskTo(x1 % wordBits);
+	for (int y = y0; y <= y1; ++y) {
+		const word_type* row = &bits[static_cast<std::size_t>(y * wordsPerRow)];
+		if (w0 == w1) {
+			blocked += popCount(row[w0] & first & last);
+			continue;
+		}
+		blocked += popCount(row[w0] & first) + popCount(row[w1] & last);
+		for (int w = w0 + 1; w < w1; ++w)
+			blocked += popCount(row[w]);
+	}
+	return blocked;
+}
+
+
+void BitmapRoom::clear() {
+	std::fill(bits.begin(), bits.end(), 0);
+}
+
+
+int BitmapRoom::popCount(word_type w) {
+	int n = 0;
+	for (; w != 0; w &= (w - 1))
+		++n;
+	return n;
+}
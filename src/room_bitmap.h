@@ -0,0 +1,66 @@
+#pragma once
+
+#include "shapes.h"
+#include <cstdint>
+#include <vector>
+
+
+class Canvas;
+
+
+// Occupancy mask of block rectangles, 1 bit per cell, stored as rows of 64-bit words
+//   so rectangle queries scan a few words per row regardless of the number of blocks.
+// Rectangles cover cells as described in room_cells.h.
+// Everything outside of bounds is blocked.
+class BitmapRoom {
+	BitmapRoom(const BitmapRoom&) = delete;
+	void operator=(const BitmapRoom&) = delete;
+	typedef uint64_t word_type;
+	static constexpr int wordBits = 64;
+public:
+	BitmapRoom() = default;
+	~BitmapRoom() = default;
+	void draw(Canvas&);		// for debug
+	void setBounds(const Rectangle&);	// clears
+	const Rectangle& getBounds(void) const;
+	void insert(const Rectangle&);
+	void build(void);	// nothing to do, insert() updates the mask
+	bool collides(const Rectangle&) const;
+	int count(const Rectangle&) const;
+	void clear(void);
+private:
+	static word_type maskFrom(const int);
+	static word_type maskTo(const int);
+	static int popCount(word_type);
+
+	std::vector<word_type> bits;
+	Rectangle bounds;
+	int cellsX = 0;
+	int cellsY = 0;
+	int wordsPerRow = 0;
+};
+
+
+inline
+const Rectangle& BitmapRoom::getBounds() const {
+	return bounds;
+}
+
+
+inline
+void BitmapRoom::build() {
+}
+
+
+// mask of bits [i, 63] in a word
+inline
+BitmapRoom::word_type BitmapRoom::maskFrom(const int i) {
+	return (~word_type{0} << i);
+}
+
+
+// mask of bits [0, i] in a word
+inline
+BitmapRoom::word_type BitmapRoom::maskTo(const int i) {
+	return (~word_type{0} >> (wordBits - 1 - i));
+}
@@ -0,0 +1,29 @@
+#include "room_cells.h"
+#ifndef NDEBUG
+#include "canvas.h"
+#include "constants.h"
+
+
+// Draw runs of blocked cells in each row
+void RoomCells::draw(Canvas& can, const Rectangle& bounds, std::function<bool(const int, const int)> blocked) {
+	const int cellsX = bounds.width() - 1;
+	const int cellsY = bounds.height() - 1;
+	auto oldColor = can.getColorState();
+	can.setColor(DEBUG_ROOM_BLOCK_COLOR, getAlpha<DEBUG_ROOM_BLOCK_ALPHA>());
+	for (int y = 0; y < cellsY; ++y) {
+		int runStart = -1;
+		for (int x = 0; x <= cellsX; ++x) {
+			const bool b = ((x < cellsX) && blocked(x, y));
+			if (b && (runStart < 0)) {
+				runStart = x;
+			}
+			else if (!b && (runStart >= 0)) {
+				can.fillRect(bounds.getX() + runStart, bounds.getY() + y, x - runStart, 1);
+				runStart = -1;
+			}
+		}
+	}
+	can.setColorState(oldColor);
+}
+
+#endif // NDEBUG
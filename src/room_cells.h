@@ -0,0 +1,49 @@
+#pragma once
+
+#include "shapes.h"
+#include <algorithm>	// max
+#include <functional>
+
+
+class Canvas;
+
+
+// How rectangles cover cells, shared by Room and every room backend so they agree.
+// A rectangle covers cells [x, cellEnd(x, width)) x [y, cellEnd(y, height)) of its
+//   inclusive coordinates, which gives the same result as Rectangle::intersects()
+//   (rectangles touching along an edge don't collide). Rectangles 1 pixel wide or
+//   high cover a single cell in that axis.
+// Bounds of a room have (width - 1) x (height - 1) cells.
+namespace RoomCells {
+	int cellEnd(const int, const int);
+	void toCells(const Rectangle&, const Rectangle&, int&, int&, int&, int&);
+	bool outside(const Rectangle&, const Rectangle&);
+	// for debug, blocked(x, y) tells if the cell relative to bounds is blocked
+	void draw(Canvas&, const Rectangle&, std::function<bool(const int, const int)>);
+}
+
+
+// End (exclusive) of the cells covered by a rectangle side
+inline
+int RoomCells::cellEnd(const int pos, const int len) {
+	return pos + std::max(len - 1, 1);
+}
+
+
+// Get inclusive cell range of r, relative to bounds (not clipped)
+inline
+void RoomCells::toCells(const Rectangle& r, const Rectangle& bounds, int& x0, int& y0, int& x1, int& y1) {
+	x0 = r.getX() - bounds.getX();
+	y0 = r.getY() - bounds.getY();
+	x1 = cellEnd(x0, r.width()) - 1;
+	y1 = cellEnd(y0, r.height()) - 1;
+}
+
+
+// does r cover any cells outside of bounds?
+inline
+bool RoomCells::outside(const Rectangle& r, const Rectangle& bounds) {
+	int x0, y0, x1, y1;
+	toCells(r, bounds, x0, y0, x1, y1);
+	return ((x0 < 0) || (y0 < 0) || (x1 >= (bounds.width() - 1)) || (y1 >= (bounds.height() - 1)));
+}
@@ -1,49 +1,86 @@
 #include "room_qtree.h"
 #include "constants.h"
+#include "room_cells.h"
+#include <algorithm>	// max, min, sort
 #include <cassert>
+
+
+// Rects cover cells [x0, x1) x [y0, y1), see room_cells.h, quad bounds cover
+//   all of their pixels
+namespace QuadtreeRoomHelper {
+
+using RoomCells::cellEnd;
+
+
+// does rect cover any pixels of quad?
+inline
+static bool inQuad(const Rectangle& quad, const Rectangle& r) {
+	return (
+		(r.getX() < (quad.getX() + quad.width()))
+		&& (cellEnd(r.getX(), r.width()) > quad.getX())
+		&& (r.getY() < (quad.getY() + quad.height()))
+		&& (cellEnd(r.getY(), r.height()) > quad.getY())
+	);
+}
+
+
+inline
+static bool overlaps(const Rectangle& a, const Rectangle& b) {
+	return (
+		(a.getX() < cellEnd(b.getX(), b.width()))
+		&& (cellEnd(a.getX(), a.width()) > b.getX())
+		&& (a.getY() < cellEnd(b.getY(), b.height()))
+		&& (cellEnd(a.getY(), a.height()) > b.getY())
+	);
+}
+
+}	// namespace QuadtreeRoomHelper
+
+
 #ifndef NDEBUG
 #include "canvas.h"
 
 
 void QuadtreeRoom::draw(Canvas& can) {
-	if (nodes != nullptr) {
-		for (std::size_t i = 0; i < QTREE_ROOM_END; ++i)
-			nodes[i].draw(can);
-	}
-	else {
-		auto oldColor = can.getColorState();
+	auto oldColor = can.getColorState();
+	for (const FlatNode& node : flatNodes) {
+		if (node.children != 0)
+			continue;
+		const Rectangle& b = node.bounds;
 		can.setColor(DEBUG_ROOM_BLOCK_COLOR, getAlpha<DEBUG_ROOM_BLOCK_ALPHA>());
-		for (const auto& r : objects)
+		for (uint32_t i = node.first; i < (node.first + node.count); ++i) {
+			const Rectangle& r = flatRects[i];
 			can.fillRect(r.getX(), r.getY(), r.width(), r.height());
+		}
 #if DEBUG_ROOM_BOUNDS
 		can.setColor(DEBUG_ROOM_BOUNDS_COLOR, getAlpha<DEBUG_ROOM_BOUNDS_ALPHA>());
 		can.fillRect(		// top
-			bounds.getX(),
-			bounds.getY(),
-			bounds.width(),
+			b.getX(),
+			b.getY(),
+			b.width(),
 			DEBUG_ROOM_BOUNDS_SIZE
 		);
 		can.fillRect(		// bottom
-			bounds.getX(),
-			bounds.getY() + bounds.height() - DEBUG_ROOM_BOUNDS_SIZE,
-			bounds.width(),
+			b.getX(),
+			b.getY() + b.height() - DEBUG_ROOM_BOUNDS_SIZE,
+			b.width(),
 			DEBUG_ROOM_BOUNDS_SIZE
 		);
 		can.fillRect(		// left
-			bounds.getX(),
-			bounds.getY(),
+			b.getX(),
+			b.getY(),
 			DEBUG_ROOM_BOUNDS_SIZE,
-			bounds.height()
+			b.height()
 		);
 		can.fillRect(		// right
-			bounds.getX() + bounds.width() - DEBUG_ROOM_BOUNDS_SIZE,
-			bounds.getY(),
+			b.getX() + b.width() - DEBUG_ROOM_BOUNDS_SIZE,
+			b.getY(),
 			DEBUG_ROOM_BOUNDS_SIZE,
-			bounds.height()
+			b.height()
 		);
 #endif // DEBUG_ROOM_BOUNDS
-		can.setColorState(oldColor);
 	}
+	can.setColorState(oldColor);
 }
 
 #endif // NDEBUG
@@ -52,13 +89,18 @@ void QuadtreeRoom::draw(Canvas& can) {
 void QuadtreeRoom::insert(const Rectangle& r) {
 	if (nodes != nullptr) {
 		for (std::size_t i = 0; i < QTREE_ROOM_END; ++i) {
-			if (nodes[i].getBounds().intersects(r))
+			if (QuadtreeRoomHelper::inQuad(nodes[i].getBounds(), r))
 				nodes[i].insert(r);
 		}
 		return;
 	}
 
-	if (objects.size() < Constants::RoomQTreeNodeCap)
+	if (
+		(objects.size() < Constants::RoomQTreeNodeCap)
+		// rects covering all of a quad would never fit
+		|| (bounds.width() < (Constants::RoomQTreeMinSz * 2))
+		|| (bounds.height() < (Constants::RoomQTreeMinSz * 2))
+	)
 		insertObject(r);
 	else {
 		split();
@@ -67,25 +109,94 @@ void QuadtreeRoom::insert(const Rectangle& r) {
 }
 
 
-// does the given rect collide with any other rects?
-bool QuadtreeRoom::collides(const Rectangle& rect) const {
-	if (!rect.intersects(bounds))
-		return false;
+// Copy the tree into flatNodes and flatRects, breadth first so the 4 children of a
+//   node are adjacent, then free the tree
+void QuadtreeRoom::build() {
+	assert(flatNodes.empty());
+	std::vector<const QuadtreeRoom*> queue{this};
+	for (std::size_t i = 0; i < queue.size(); ++i) {
+		const QuadtreeRoom* qt = queue[i];
+		FlatNode node;
+		node.bounds = qt->bounds;
+		node.children = 0;
+		node.first = static_cast<uint32_t>(flatRects.size());
+		node.count = static_cast<uint32_t>(qt->objects.size());
+		if (qt->nodes != nullptr) {
+			// children are added to queue, and so flatNodes, in order
+			node.children = static_cast<uint32_t>(queue.size());
+			for (std::size_t j = 0; j < QTREE_ROOM_END; ++j)
+				queue.push_back(&qt->nodes[j]);
+		}
+		flatRects.insert(flatRects.end(), qt->objects.begin(), qt->objects.end());
+		flatNodes.push_back(node);
+	}
+	flatNodes.shrink_to_fit();
+	flatRects.shrink_to_fit();
+	objects.clear();
+	objects.shrink_to_fit();
 	if (nodes != nullptr) {
-		return (
-			nodes[QTREE_ROOM_NW].collides(rect)
-			|| nodes[QTREE_ROOM_NE].collides(rect)
-			|| nodes[QTREE_ROOM_SW].collides(rect)
-			|| nodes[QTREE_ROOM_SE].collides(rect)
-		);
+		delete[] nodes;
+		nodes = nullptr;
 	}
-	else {
-		for (const auto& r : objects) {
-			if (rect.intersects(r))
-				return true;
+}
+
+
+// does the given rect collide with any block rects or leave bounds?
+bool QuadtreeRoom::collides(const Rectangle& rect) const {
+	assert(!flatNodes.empty());
+	return (outside(rect) || collidesFlat(0, rect));
+}
+
+
+// Number of blocked pixels in rect, pixels outside of bounds are blocked
+// Pixels are covered as in room_cells.h, a rect covers [x0, x1) x [y0, y1)
+int QuadtreeRoom::count(const Rectangle& rect) const {
+	using RoomCells::cellEnd;
+	assert(!flatNodes.empty());
+	const int x0 = rect.getX();
+	const int y0 = rect.getY();
+	const int x1 = cellEnd(x0, rect.width());
+	const int y1 = cellEnd(y0, rect.height());
+	const int bx0 = bounds.getX();
+	const int by0 = bounds.getY();
+	const int bx1 = bx0 + bounds.width() - 1;
+	const int by1 = by0 + bounds.height() - 1;
+	// local, so count() can be called from any thread
+	std::vector<Rectangle> rects;
+	std::vector<IntPair> spans;	// reused by every row
+	collectFlat(0, rect, rects);
+	int blocked = 0;
+	for (int y = y0; y < y1; ++y) {
+		// merge the spans of rects on this row, clipped to rect and bounds
+		const int sx0 = std::max(x0, bx0);
+		const int sx1 = std::min(x1, bx1);
+		if ((y < by0) || (y >= by1) || (sx0 >= sx1)) {
+			blocked += x1 - x0;
+			continue;
+		}
+		blocked += (x1 - x0) - (sx1 - sx0);
+		spans.clear();
+		for (const Rectangle& r : rects) {
+			if ((y < r.getY()) || (y >= cellEnd(r.getY(), r.height())))
+				continue;
+			const int rx0 = std::max(r.getX(), sx0);
+			const int rx1 = std::min(cellEnd(r.getX(), r.width()), sx1);
+			if (rx0 < rx1)
+				spans.emplace_back(rx0, rx1);
+		}
+		std::sort(spans.begin(), spans.end(), [](const IntPair& a, const IntPair& b) {
+			return (a.first < b.first);
+		});
+		int end = sx0;
+		for (const IntPair& s : spans) {
+			const int start = std::max(s.first, end);
+			if (s.second > start) {
+				blocked += s.second - start;
+				end = s.second;
+			}
 		}
-		return false;
 	}
+	return blocked;
 }
 
 
@@ -96,6 +207,10 @@ void QuadtreeRoom::clear() {
 		delete[] nodes;
 		nodes = nullptr;
 	}
+	std::vector<FlatNode> emptyNodes;
+	flatNodes.swap(emptyNodes);
+	std::vector<Rectangle> emptyRects;
+	flatRects.swap(emptyRects);
 }
 
 
@@ -131,9 +246,10 @@ void QuadtreeRoom::split() {
 #endif // NDEBUG
 	// move rects into new quads
 	for (const auto& r : objects) {
-		// no checking needed since new quad only inserts correct part of rect
-		for (std::size_t i = 0; i < QTREE_ROOM_END; ++i)
-			nodes[i].insert(r);
+		for (std::size_t i = 0; i < QTREE_ROOM_END; ++i) {
+			if (QuadtreeRoomHelper::inQuad(nodes[i].getBounds(), r))
+				nodes[i].insert(r);
+		}
 	}
 	objects.clear();
 	objects.shrink_to_fit();
@@ -141,8 +257,43 @@ void QuadtreeRoom::split() {
 
 
 void QuadtreeRoom::insertObject(const Rectangle& r) {
-	// only insert part of rect that is inside bounds
-	Rectangle nrect = bounds.intersection(r);
-	if (!nrect.empty())
-		objects.push_back(nrect);
+	objects.push_back(r);
+}
+
+
+bool QuadtreeRoom::collidesFlat(const uint32_t index, const Rectangle& rect) const {
+	const FlatNode& node = flatNodes[index];
+	if (!QuadtreeRoomHelper::inQuad(node.bounds, rect))
+		return false;
+	if (node.children != 0) {
+		for (uint32_t i = node.children; i < (node.children + QTREE_ROOM_END); ++i) {
+			if (collidesFlat(i, rect))
+				return true;
+		}
+		return false;
+	}
+	for (uint32_t i = node.first; i < (node.first + node.count); ++i) {
+		if (QuadtreeRoomHelper::overlaps(rect, flatRects[i]))
+			return true;
+	}
+	return false;
+}
+
+
+// add rects of leaves intersecting rect to found
+void QuadtreeRoom::collectFlat(const uint32_t index, const Rectangle& rect, std::vector<Rectangle>& found) const {
+	const FlatNode& node = flatNodes[index];
+	if (!QuadtreeRoomHelper::inQuad(node.bounds, rect))
+		return;
+	if (node.children != 0) {
+		for (uint32_t i = node.children; i < (node.children + QTREE_ROOM_END); ++i)
+			collectFlat(i, rect, found);
+		return;
+	}
+	found.insert(found.end(), flatRects.begin() + node.first, flatRects.begin() + node.first + node.count);
+}
+
+
+bool QuadtreeRoom::outside(const Rectangle& r) const {
+	return RoomCells::outside(r, bounds);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "shapes.h"
+#include "utility_struct.h"	// IntPair
+#include <cstdint>
 #include <vector>
 
 
@@ -8,11 +10,22 @@ class Canvas;
 
 
 // A quadtree specifically for block rectangles
-// Rather than leave rects that don't fit into a new quad in parent, split it so it does
+// Rather than leave rects that don't fit into a new quad in parent, add it to every
+//   quad it covers. Rects cover cells as described in room_cells.h.
+// Rects are inserted into a tree of separately allocated nodes, then build() freezes
+//   it into one array of nodes (children of a node are adjacent) and one array of
+//   rects, which is what queries use.
+// Everything outside of bounds is blocked.
 class QuadtreeRoom {
 	QuadtreeRoom(const QuadtreeRoom&) = delete;
 	void operator=(const QuadtreeRoom&) = delete;
 	enum Indices : unsigned int {QTREE_ROOM_NW = 0, QTREE_ROOM_NE, QTREE_ROOM_SW, QTREE_ROOM_SE, QTREE_ROOM_END};
+	struct FlatNode {
+		Rectangle bounds;
+		uint32_t children;	// index of first child, 0 if leaf
+		uint32_t first;	// index of first rect, if leaf
+		uint32_t count;
+	};
 public:
 	QuadtreeRoom() = default;
 	~QuadtreeRoom();
@@ -20,15 +33,23 @@ public:
 	void setBounds(const Rectangle&);
 	const Rectangle& getBounds(void) const;
 	void insert(const Rectangle&);
+	void build(void);	// call after inserting all rects
 	bool collides(const Rectangle&) const;
+	int count(const Rectangle&) const;
 	void clear(void);
 private:
 	void split(void);
 	void insertObject(const Rectangle&);
+	bool collidesFlat(const uint32_t, const Rectangle&) const;
+	void collectFlat(const uint32_t, const Rectangle&, std::vector<Rectangle>&) const;
+	bool outside(const Rectangle&) const;
 
 	std::vector<Rectangle> objects;
 	Rectangle bounds;
 	QuadtreeRoom* nodes = nullptr;
+	// frozen tree, root is flatNodes[0]
+	std::vector<FlatNode> flatNodes;
+	std::vector<Rectangle> flatRects;
 };
 
 
@@ -0,0 +1,98 @@
+#include "room_sat.h"
+#include "room_cells.h"
+#include <algorithm>	// fill, max, min
+#include <cassert>
+#ifndef NDEBUG
+
+
+void SATRoom::draw(Canvas& can) {
+	RoomCells::draw(can, bounds, [this](const int x, const int y) {
+		return (countCells(x, y, x, y) > 0);
+	});
+}
+
+#endif // NDEBUG
+
+
+void SATRoom::setBounds(const Rectangle& r) {
+	assert((r.width() > 1) && (r.height() > 1));
+	bounds = r;
+	cellsX = bounds.width() - 1;
+	cellsY = bounds.height() - 1;
+	sums.assign(static_cast<std::size_t>((cellsX + 1) * (cellsY + 1)), 0);
+	built = false;
+}
+
+
+// only the part of rect inside bounds is stored
+void SATRoom::insert(const Rectangle& r) {
+	assert(!built);
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, cellsX - 1);
+	y1 = std::min(y1, cellsY - 1);
+	if ((x0 > x1) || (y0 > y1))
+		return;
+	for (int y = y0; y <= y1; ++y) {
+		sum_type* row = &sums[static_cast<std::size_t>((y + 1) * (cellsX + 1))];
+		std::fill(row + x0 + 1, row + x1 + 2, 1);
+	}
+}
+
+
+// Replace coverage with running sums, row by row
+void SATRoom::build() {
+	assert(!built);
+	const std::size_t stride = static_cast<std::size_t>(cellsX + 1);
+	for (std::size_t y = 1; y < static_cast<std::size_t>(cellsY + 1); ++y) {
+		sum_type* row = &sums[y * stride];
+		const sum_type* above = row - stride;
+		sum_type rowSum = 0;
+		for (std::size_t x = 1; x < stride; ++x) {
+			rowSum += row[x];
+			row[x] = above[x] + rowSum;
+		}
+	}
+	built = true;
+}
+
+
+// does the given rect collide with any block rects or leave bounds?
+bool SATRoom::collides(const Rectangle& r) const {
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	if ((x0 < 0) || (y0 < 0) || (x1 >= cellsX) || (y1 >= cellsY))
+		return true;
+	return (countCells(x0, y0, x1, y1) > 0);
+}
+
+
+// Number of blocked cells in rect, cells outside of bounds are blocked
+int SATRoom::count(const Rectangle& r) const {
+	int x0, y0, x1, y1;
+	RoomCells::toCells(r, bounds, x0, y0, x1, y1);
+	const int area = (x1 - x0 + 1) * (y1 - y0 + 1);
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, cellsX - 1);
+	y1 = std::min(y1, cellsY - 1);
+	if ((x0 > x1) || (y0 > y1))
+		return area;
+	const int inside = (x1 - x0 + 1) * (y1 - y0 + 1);
+	return (area - inside) + countCells(x0, y0, x1, y1);
+}
+
+
+void SATRoom::clear() {
+	std::fill(sums.begin(), sums.end(), 0);
+	built = false;
+}
+
+
+// inclusive cell range, must be inside bounds
+int SATRoom::countCells(const int x0, const int y0, const int x1, const int y1) const {
+	assert(built);
+	return static_cast<int>(at(x1 + 1, y1 + 1) - at(x0, y1 + 1) - at(x1 + 1, y0) + at(x0, y0));
+}
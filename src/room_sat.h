@@ -0,0 +1,54 @@
+#pragma once
+
+#include "shapes.h"
+#include <cstdint>
+#include <vector>
+
+
+class Canvas;
+
+
+// Summed-area table of block rectangles, so the number of blocked cells in any
+//   rectangle is 4 lookups. Cells are covered as described in room_cells.h.
+// Rectangles are inserted first, then build() turns the coverage into the table.
+// Everything outside of bounds is blocked.
+class SATRoom {
+	SATRoom(const SATRoom&) = delete;
+	void operator=(const SATRoom&) = delete;
+	typedef int32_t sum_type;
+public:
+	SATRoom() = default;
+	~SATRoom() = default;
+	void draw(Canvas&);		// for debug
+	void setBounds(const Rectangle&);	// clears
+	const Rectangle& getBounds(void) const;
+	void insert(const Rectangle&);
+	void build(void);	// call after inserting all rects
+	bool collides(const Rectangle&) const;
+	int count(const Rectangle&) const;
+	void clear(void);
+private:
+	sum_type at(const int, const int) const;
+	int countCells(const int, const int, const int, const int) const;
+
+	// (cellsX + 1) * (cellsY + 1), first row and column are 0
+	// before build() a cell is 1 if covered
+	std::vector<sum_type> sums;
+	Rectangle bounds;
+	int cellsX = 0;
+	int cellsY = 0;
+	bool built = false;
+};
+
+
+inline
+const Rectangle& SATRoom::getBounds() const {
+	return bounds;
+}
+
+
+// sum of cells [0, x) x [0, y)
+inline
+SATRoom::sum_type SATRoom::at(const int x, const int y) const {
+	return sums[static_cast<std::size_t>((y * (cellsX + 1)) + x)];
+}
@@ -6,6 +6,7 @@
 #include "logger.h"
 #include "sdl_helper.h"
 #include "utility.h"	// q
+#include <algorithm>	// max
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 #include <boost/program_options.hpp>
@@ -59,6 +60,15 @@ int readInt(const T& map, const std::string& key) {
 }
 
 
+// same as readInt(), but key is optional
+template<class T>
+int readInt(const T& map, const std::string& key, const int defaultVal) {
+	if (map.find(key) == map.end())
+		return defaultVal;
+	return readInt(map, key);
+}
+
+
 // notify that something exceptional happened, not necessarily an error
 struct SettingsException {
 	bool errorFlag;
@@ -118,6 +128,14 @@ void setupArguments(const int argc, char** argv, po::variables_map& vm) {
 		("about", "information about this application")
 		("drivers", "display available 2D rendering drivers")
 		("savedir", po::value<std::string>(), "set save directory")
+		("headless", po::value<long>()->implicit_value(SettingsSettings::defaultHeadlessTicks),
+			"run game updates without rendering for arg ticks (0 = until quit) and report ticks per second")
+		("record", po::value<std::string>(), "record input events to file")
+		("replay", po::value<std::string>(), "replay input events from file recorded with --record")
+		("trace", po::value<std::string>(), "write Chrome trace events to file")
+		("bench", po::value<int>()->implicit_value(SettingsSettings::defaultBenchCreatures),
+			"run the creature benchmark with arg creatures and report tick rate, frame times and allocations")
+		("bench-spawners", po::value<int>(), "number of spawners in the creature benchmark (default creatures / 100)")
 	;
 	try {
 		po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -167,9 +185,18 @@ void procIni(Settings& settings) {
 		settings.renderer = it->second;
 	settings.minFPS = readInt(iniMap, "MinFPS");
 	settings.maxFPS = readInt(iniMap, "MaxFPS");
+	settings.tickRate = readInt(iniMap, "TickRate", defaultTickRate);
+	if (settings.tickRate <= 0) {
+		// the fixed step is 1 / tickRate
+		Console::begin() << "Warning: TickRate must be positive, using "
+		                 << defaultTickRate << " instead." << std::endl;
+		settings.tickRate = defaultTickRate;
+	}
 	setFlag(iniMap, "Vsync", settings.flags, toIndex(Index::VSYNC));
 	setFlag(iniMap, "DisplayFPS", settings.flags, toIndex(Index::DISPLAYFPS));
 	setFlag(iniMap, "PauseFocusLost", settings.flags, toIndex(Index::PAUSEFOCUSLOST));
+	setFlag(iniMap, "FixedStep", settings.flags, toIndex(Index::FIXEDSTEP));
+	setFlag(iniMap, "BatchDraw", settings.flags, toIndex(Index::BATCHDRAW));
 }
 
 
@@ -179,6 +206,28 @@ void procArguments(po::variables_map& vm, Settings& settings) {
 		// arguments provided by command-line override ini file
 		settings.savePath = fs::absolute(vm["savedir"].as<std::string>()).string();
 	}
+	if (vm.count("headless")) {
+		settings.flags.set(toIndex(Index::HEADLESS));
+		settings.headlessTicks = std::max(vm["headless"].as<long>(), 0L);
+	}
+	if (vm.count("replay")) {
+		settings.replayPath = fs::absolute(vm["replay"].as<std::string>()).string();
+		if (vm.count("record"))
+			Console::begin() << "Ignoring --record since --replay was given." << std::endl;
+	}
+	else if (vm.count("record")) {
+		settings.recordPath = fs::absolute(vm["record"].as<std::string>()).string();
+	}
+	if (vm.count("trace"))
+		settings.tracePath = fs::absolute(vm["trace"].as<std::string>()).string();
+	if (vm.count("bench")) {
+		settings.flags.set(toIndex(Index::BENCH));
+		settings.benchCreatures = std::max(vm["bench"].as<int>(), 0);
+		if (vm.count("bench-spawners"))
+			settings.benchSpawners = std::max(vm["bench-spawners"].as<int>(), 0);
+		else
+			settings.benchSpawners = (settings.benchCreatures / benchSpawnerDiv);
+	}
 }
 
 
@@ -252,6 +301,8 @@ Settings::Settings(int argc, char** argv) {
 	SET_FLAG(flags, toIndex(Index::VSYNC), fVsync);
 	SET_FLAG(flags, toIndex(Index::DISPLAYFPS), fDisplayFPS);
 	SET_FLAG(flags, toIndex(Index::PAUSEFOCUSLOST), fPauseFocusLost);
+	SET_FLAG(flags, toIndex(Index::FIXEDSTEP), fFixedStep);
+	SET_FLAG(flags, toIndex(Index::BATCHDRAW), fBatchDraw);
 	po::variables_map vm;
 	try {
 		// set rootPath and Logger path
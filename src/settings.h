@@ -9,13 +9,19 @@
 namespace SettingsSettings {
 	typedef unsigned int index_type;
 	// indices of bitset
-	enum class Index : index_type {VSYNC=0, DISPLAYFPS, PAUSEFOCUSLOST};
+	enum class Index : index_type {VSYNC=0, DISPLAYFPS, PAUSEFOCUSLOST, FIXEDSTEP, HEADLESS, BENCH, BATCHDRAW};
 	constexpr char defaultDataDir[] = "data";
 	constexpr char defaultSaveDir[] = "save";
+	constexpr int defaultTickRate = 60;	// fixed-step updates per second
+	constexpr long defaultHeadlessTicks = 3600;	// updates to simulate in headless mode
+	constexpr int defaultBenchCreatures = 1000;
+	constexpr int benchSpawnerDiv = 100;	// default spawners in benchmark = creatures / benchSpawnerDiv
 	// default flag values
 	constexpr bool fVsync = true;
 	constexpr bool fDisplayFPS = false;
 	constexpr bool fPauseFocusLost = true;
+	constexpr bool fFixedStep = true;
+	constexpr bool fBatchDraw = true;
 
 	inline
 	constexpr index_type toIndex(const Index i) {
@@ -37,9 +43,16 @@ public:
 	std::string dataPath;
 	std::string savePath;
 	std::string renderer;	// name of renderer to use
+	std::string recordPath;	// empty if not recording events
+	std::string replayPath;	// empty if not replaying events
+	std::string tracePath;	// empty if not tracing
 	std::bitset<8> flags;
 	int minFPS;
 	int maxFPS;
+	int tickRate;
+	long headlessTicks = 0;	// only used with HEADLESS flag, 0 = run until quit
+	int benchCreatures = 0;	// only used with BENCH flag
+	int benchSpawners = 0;
 	bool exitFlag = false;	// exit immediately after constructor?
 };
 
@@ -1,24 +1,15 @@
 #include "spell.h"
 #include "utility.h"
-#include "vfx_fade.h"
 #include <cassert>
 #include <cmath>	// sqrt
 
 
-Spell::Spell() : fade(new VFXFade) {
-	fade->setFade(Constants::SMFadeDur, SDL_ALPHA_OPAQUE, SDL_ALPHA_TRANSPARENT);
-}
-
-
-Spell::~Spell() {
-	if (fade != nullptr) {
-		delete fade;
-		fade = nullptr;
-	}
+Spell::Spell() : endPos(0, 0) {
 }
 
 
 bool Spell::update(const Constants::float_type dt) {
+	savePrevPos();
 	if ((timeRem - dt) <= 0) {
 		pos += (vel * timeRem);
 		pos.x = correctFloat(pos.x);
@@ -43,7 +34,7 @@ void Spell::setPos(const SDL_Rect& entityRect, const int offsetY) {
 // this assumes that current position is integer
 // speed is distance per second
 void Spell::setEndPos(const int x, const int y, const Constants::float_type speed) {
-	fade->setOffset(x, y);	// needs to be updated in subclass
+	endPos = IntPair{x, y};
 	Vector2D<> deltaPos{
 		static_cast<Constants::float_type>(x - static_cast<int>(pos.x)),
 		static_cast<Constants::float_type>(y - static_cast<int>(pos.y))
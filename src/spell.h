@@ -5,24 +5,22 @@
 #include "utility_struct.h"
 
 
-// NOTE: because VFXFade offset is top-left coordinate,
-// needs to be set again by Spell subclass after released to properly center.
-class VFXFade;
-
-
 class Spell : public Attack {
 public:
 	Spell();
-	~Spell();
+	~Spell() {/* do nothing */}
 	bool update(const Constants::float_type) override;
 	virtual void chargeTick(const Constants::float_type) = 0;
 	void setPos(const SDL_Rect&, const int);
 	void setEndPos(const int, const int, const Constants::float_type);
 	int getRadius(void) const;
+	void savePrevPos(void);
+	Vector2D<> getDrawPos(const Constants::float_type) const;
 protected:
 	Vector2D<> pos;
+	Vector2D<> prevPos;	// pos at start of update, see GameEntity
 	Vector2D<> vel;	// velocity
-	VFXFade* fade;
+	IntPair endPos;	// subclass centers its VFXFade here when it hits
 	Constants::float_type timeRem;
 	Constants::float_type radius;
 };
@@ -32,3 +30,15 @@ inline
 int Spell::getRadius() const {
 	return static_cast<int>(radius);
 }
+
+
+inline
+void Spell::savePrevPos() {
+	prevPos = pos;
+}
+
+
+inline
+Vector2D<> Spell::getDrawPos(const Constants::float_type alpha) const {
+	return (prevPos + ((pos - prevPos) * alpha));
+}
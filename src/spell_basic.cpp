@@ -18,14 +18,13 @@ SpellBasic::SpellBasic(Image* img) : image(img), dradius(0), radiusLimit(5) {
 bool SpellBasic::update(const Constants::float_type dt) {
 	if (Spell::update(dt)) {
 		const int fadeRad = static_cast<int>(radius * Constants::SMFadeRadMult);
+		VFXManager& vfxm = GameData::instance().mgo->getVFXManager();
+		VFXFade* fade = vfxm.newFade();
+		fade->setFade(Constants::SMFadeDur, SDL_ALPHA_OPAQUE, SDL_ALPHA_TRANSPARENT);
 		fade->setImage(image, fadeRad * 2, fadeRad * 2);
 		// center the fade
-		fade->setOffset(
-			fade->getOffsetX() - fadeRad,
-			fade->getOffsetY() - fadeRad
-		);
-		GameData::instance().mgo->getVFXManager().add(fade);
-		fade = nullptr;	// VFXManager now owns fade
+		fade->setOffset(endPos.first - fadeRad, endPos.second - fadeRad);
+		vfxm.add(fade);
 		GameData::instance().mgo->getAttackManager().procCirc(
 			this,
 			Circle{
@@ -44,9 +43,10 @@ bool SpellBasic::update(const Constants::float_type dt) {
 void SpellBasic::draw(Canvas& can) {
 	assert(image != nullptr);
 	const int radiusInt = getRadius();
+	const Vector2D<> drawPos = getDrawPos(can.getInterpolation());
 	image->setWidth(radiusInt * 2);
 	image->setHeight(radiusInt * 2);
-	can.draw(*image, static_cast<int>(pos.x) - radiusInt, static_cast<int>(pos.y) - radiusInt);
+	can.draw(*image, static_cast<int>(drawPos.x) - radiusInt, static_cast<int>(drawPos.y) - radiusInt);
 }
 
 
@@ -55,7 +55,7 @@ void SpellManager::playerRelease(Spell*& spell) {
 
 
 Spell* SpellManager::newPlayerSpellBasic() {
-	SpellBasic* s = new SpellBasic{imgBasic.get()};
+	SpellBasic* s = GameData::instance().mgo->getAttackManager().newSpellBasic(imgBasic.get());
 	s->setSource(&(GameData::instance().mgo->getPlayer()));
 	s->setTarget(AttackTarget::CREATURES);
 	s->init(1, 15, 18);	//! upgrades not implemented
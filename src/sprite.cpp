@@ -3,16 +3,19 @@
 #include <cassert>
 
 
-Sprite::Sprite(SDL_Surface* s, SDL_Texture* t, const SDL_Rect& r) : clip(r), surf(s), tex(t) {
+Sprite::Sprite(SDL_Surface* s, SDL_Texture* t, const SDL_Rect& r, const SDL_Rect& tr) :
+	clip(r), texClip(tr), surf(s), tex(t)
+{
 }
 
 
-Sprite::Sprite(const Sprite& o): clip(o.clip), surf(o.surf), tex(o.tex) {
+Sprite::Sprite(const Sprite& o): clip(o.clip), texClip(o.texClip), surf(o.surf), tex(o.tex) {
 }
 
 
 Sprite& Sprite::operator=(const Sprite& that) {
 	clip = that.clip;
+	texClip = that.texClip;
 	surf = that.surf;
 	tex = that.tex;
 	return *this;
@@ -20,8 +23,7 @@ Sprite& Sprite::operator=(const Sprite& that) {
 
 
 void Sprite::draw(Canvas& can, const int x, const int y) {
-	SDL_Rect r{x, y, clip.w, clip.h};
-	can.draw(tex, &r);
+	can.draw(*this, x, y);
 }
 
 
@@ -38,7 +40,7 @@ SDL_Texture* Sprite::getTexture() {
 
 
 SDL_Rect* Sprite::getTextureBounds() {
-	return &clip;
+	return &texClip;
 }
 
 
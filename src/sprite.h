@@ -9,10 +9,11 @@ class Canvas;
 
 // Represents a sprite from a SpriteSheet.
 // Invalid once SpriteSheet is destroyed.
+// The texture may be an atlas, so its clip rect can differ from the surface's.
 class Sprite : public Drawable {
 public:
 	Sprite() = default;
-	Sprite(SDL_Surface*, SDL_Texture*, const SDL_Rect&);
+	Sprite(SDL_Surface*, SDL_Texture*, const SDL_Rect&, const SDL_Rect&);
 	Sprite(const Sprite&);
 	~Sprite() {}
 	Sprite& operator=(const Sprite&);
@@ -24,7 +25,8 @@ public:
 	int getDrawWidth(void) const;
 	int getDrawHeight(void) const;
 private:
-	SDL_Rect clip = {0, 0, 0, 0};
+	SDL_Rect clip = {0, 0, 0, 0};	// in surf
+	SDL_Rect texClip = {0, 0, 0, 0};	// in tex
 	SDL_Surface* surf = nullptr;
 	SDL_Texture* tex = nullptr;
 };
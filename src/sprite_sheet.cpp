@@ -10,7 +10,8 @@ Sprite SpriteSheet::get(const std::string& name) const {
 	assert(it != sprites.end());
 	if (it == sprites.end())
 		Logger::instance().exit(RuntimeError{"SpriteSheet::get", "invalid name: " + name});
-	return Sprite{surf, tex, it->second};
+	const SDL_Rect& r = it->second;
+	return Sprite{surf, tex, r, SDL_Rect{r.x + texPos.x, r.y + texPos.y, r.w, r.h}};
 }
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sdl_header.h"
+#include "texture_atlas.h"
 #include <string>
 #include <unordered_map>
 
@@ -9,6 +10,7 @@ class ResourceManager;
 class Sprite;
 
 
+// Sprite rects are in the image, texPos is where the image is in tex
 class SpriteSheet {
 	friend ResourceManager;
 public:
@@ -20,10 +22,13 @@ public:
 	SDL_Texture* getTexture(void);
 	const std::string& getImageName(void) const;
 private:
+	void setTexture(const AtlasRegion&);
+
 	std::unordered_map<std::string, SDL_Rect> sprites;
 	std::string imgName;
 	SDL_Surface* surf = nullptr;
 	SDL_Texture* tex = nullptr;
+	SDL_Point texPos = {0, 0};
 };
 
 
@@ -43,3 +48,11 @@ inline
 const std::string& SpriteSheet::getImageName() const {
 	return imgName;
 }
+
+
+inline
+void SpriteSheet::setTexture(const AtlasRegion& region) {
+	tex = region.tex;
+	texPos.x = region.rect.x;
+	texPos.y = region.rect.y;
+}
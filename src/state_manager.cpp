@@ -4,6 +4,7 @@
 #include "game_state.h"
 #include "logger.h"
 #include "state_context.h"
+#include "trace.h"
 #ifndef NDEBUG
 #include "constants.h"
 #endif
@@ -15,6 +16,7 @@
 #include "gs_load_menu.h"
 #include "gs_save_menu.h"
 #include "gs_dialog.h"
+#include "gs_bench.h"
 
 
 namespace StMHelper {
@@ -286,22 +288,32 @@ bool StateManager::doProcEvents() {
 	currentEvent = futureEvent;
 	futureEvent = nullptr;
 	switch(currentEvent->eventType) {
-	case EventType::PUSH:
+	case EventType::PUSH: {
+		TraceScope ts{"state push", toString(currentEvent->stateType)};
 		processPush(currentEvent);
 		break;
-	case EventType::POP:
+	}
+	case EventType::POP: {
+		TraceScope ts{"state pop"};
 		processPop(currentEvent);
 		break;
-	case EventType::SWITCH:
+	}
+	case EventType::SWITCH: {
+		TraceScope ts{"state switch", toString(currentEvent->stateType)};
 		processSwitch(currentEvent);
 		break;
-	case EventType::SET:
+	}
+	case EventType::SET: {
+		TraceScope ts{"state set", toString(currentEvent->stateType)};
 		processSet(currentEvent);
 		break;
-	case EventType::EXIT:
+	}
+	case EventType::EXIT: {
+		TraceScope ts{"state exit"};
 		processExit(currentEvent);
 		break;
 	}
+	}
 	delete currentEvent;
 	currentEvent = nullptr;
 	return (futureEvent != nullptr);
@@ -376,6 +388,13 @@ GameState* StateManager::newGameState(const StateType st, std::shared_ptr<StateC
 		gs = new DialogState{sc};
 		assert(gs->getType() == StateType::DIALOG);
 		break;
+	case StateType::BENCH:
+#if defined(DEBUG_StM_NEW_DEL) && DEBUG_StM_NEW_DEL
+		DEBUG_OS << toString(StateType::BENCH) << std::endl;
+#endif
+		gs = new Benchmark{sc};
+		assert(gs->getType() == StateType::BENCH);
+		break;
 	default:
 #if defined(DEBUG_StM_NEW_DEL) && DEBUG_StM_NEW_DEL
 		DEBUG_OS << "???" << std::endl;
@@ -1,4 +1,3 @@
-#ifndef NDEBUG
 #include "state_type.h"
 #include <cassert>
 
@@ -30,10 +29,11 @@ std::string toString(const StateType st) {
 	case StateType::DIALOG:
 		str = "DIALOG";
 		break;
+	case StateType::BENCH:
+		str = "BENCH";
+		break;
 	default:
 		assert(false);
 	}
 	return str;
 }
-
-#endif // NDEBUG
@@ -1,12 +1,9 @@
 #pragma once
 
-enum class StateType {NONE, INIT, MENU, GAME, GAME_MENU, LOAD_MENU, SAVE_MENU, DIALOG};
+#include <string>
 
 
-#ifndef NDEBUG
-#include <string>
+enum class StateType {NONE, INIT, MENU, GAME, GAME_MENU, LOAD_MENU, SAVE_MENU, DIALOG, BENCH};
 
 
 std::string toString(const StateType);
-
-#endif // NDEBUG
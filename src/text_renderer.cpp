@@ -2,6 +2,7 @@
 #include "exception.h"
 #include "font.h"
 #include "game_data.h"
+#include "glyph_atlas.h"
 #include "logger.h"
 #include "resource_manager.h"
 #include <cassert>
@@ -70,9 +71,29 @@ void TextRenderer::size(const std::string& text, int& width, int& height) {
 }
 
 
+// Draw str with its top left at (x, y)
+void TextRenderer::draw(Canvas& can, const std::string& str, const int x, const int y) {
+	getGlyphs()->draw(can, str, x, y, Color{col.r, col.g, col.b});
+}
+
+
+int TextRenderer::drawWidth(const std::string& str) {
+	return getGlyphs()->width(str);
+}
+
+
 void TextRenderer::freeFont() {
+	glyphs = nullptr;
 	if (fr.font != nullptr) {
 		GameData::instance().resources->unloadFont(fr);
 		fr.font = nullptr;
 	}
 }
+
+
+GlyphAtlas* TextRenderer::getGlyphs() {
+	assert(fr.font != nullptr);
+	if (glyphs == nullptr)
+		glyphs = GameData::instance().resources->getGlyphAtlas(fr);
+	return glyphs;
+}
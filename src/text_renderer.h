@@ -5,7 +5,9 @@
 #include "sdl_helper.h"
 
 
+class Canvas;
 class Font;
+class GlyphAtlas;
 
 
 enum class TextRenderType {SOLID, SHADED, BLENDED};
@@ -20,6 +22,8 @@ struct FontMetrics {
 
 
 // Note: temporary implementation of using TTF_RenderText_Blended_Wrapped() to render wrapped text.
+// draw() draws from the glyph atlas of the font instead of rendering a surface,
+//   for text that changes often. Render type is ignored, it is always blended.
 class TextRenderer {
 	TextRenderer(const TextRenderer&) = delete;
 	void operator=(const TextRenderer&) = delete;
@@ -34,10 +38,15 @@ public:
 	SDL_Surface* render(const char*);
 	SDL_Surface* renderWrap(const std::string&, const int);
 	void size(const std::string&, int&, int&);
+	void draw(Canvas&, const std::string&, const int, const int);
+	int drawWidth(const std::string&);	// of text drawn with draw()
 	const FontMetrics& getMetrics(void) const;
 	void freeFont(void);
 private:
+	GlyphAtlas* getGlyphs(void);
+
 	FontResource fr;
+	GlyphAtlas* glyphs = nullptr;	// from ResourceManager
 	FontMetrics metrics;
 	TextRenderType renderType = TextRenderType::BLENDED;
 	SDL_Color col;
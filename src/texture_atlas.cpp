@@ -0,0 +1,157 @@
+#include "texture_atlas.h"
+#include "exception.h"
+#include "logger.h"
+#include "sdl_helper.h"
+#include <algorithm>	// max
+#include <cassert>
+#include <cstddef>	// ptrdiff_t
+
+
+TextureAtlas::~TextureAtlas() {
+	clear();
+}
+
+
+// Copy surface into a page, color key becomes transparency like with
+//   SDL_CreateTextureFromSurface
+AtlasRegion TextureAtlas::add(SDL_Surface* surf) {
+	using namespace TextureAtlasSettings;
+	assert(surf != nullptr);
+	AtlasRegion region;
+	const int w = (surf->w + (padding * 2));
+	const int h = (surf->h + (padding * 2));
+	if ((w > pageSize) || (h > pageSize)) {
+		region.tex = SDL::newTexture(surf);
+		if (region.tex == nullptr)
+			Logger::instance().exit(SDLError{"unable to create texture", SDLFunc::SDL_CreateTextureFromSurface});
+		region.rect = SDL_Rect{0, 0, surf->w, surf->h};
+		return region;
+	}
+	SDL_Rect area;
+	std::size_t i = 0;
+	while ((i < pages.size()) && !place(pages[i], w, h, area))
+		++i;
+	if (i == pages.size()) {
+		pages.push_back(newPage());
+		const bool placed = place(pages.back(), w, h, area);
+		assert(placed);
+		(void)placed;	// remove warning
+	}
+	Page& page = pages[i];
+	// new surfaces are cleared, so the border stays transparent
+	SDL_Surface* padded = SDL::newSurface32(w, h);
+	SDL_BlendMode mode;
+	SDL_GetSurfaceBlendMode(surf, &mode);
+	SDL_SetSurfaceBlendMode(surf, SDL_BLENDMODE_NONE);
+	SDL_Rect dst{padding, padding, surf->w, surf->h};
+	SDL_BlitSurface(surf, nullptr, padded, &dst);
+	SDL_SetSurfaceBlendMode(surf, mode);
+	if (SDL_UpdateTexture(page.tex, &area, padded->pixels, padded->pitch) != 0)
+		SDL::logError("TextureAtlas::add SDL_UpdateTexture");
+	SDL::free(padded);
+	++page.regions;
+	region.tex = page.tex;
+	region.rect = SDL_Rect{area.x + padding, area.y + padding, surf->w, surf->h};
+	region.page = i;
+	return region;
+}
+
+
+void TextureAtlas::remove(const AtlasRegion& region) {
+	if (region.tex == nullptr)
+		return;
+	if (region.page == Constants::maxIndex) {
+		SDL::free(region.tex);
+		return;
+	}
+	assert(region.page < pages.size());
+	Page& page = pages[region.page];
+	assert(page.tex == region.tex);
+	assert(page.regions > 0);
+	if (--page.regions == 0)
+		resetSkyline(page);
+}
+
+
+// Regions given by add() are invalid after this
+void TextureAtlas::clear() {
+	for (Page& page : pages)
+		SDL::free(page.tex);
+	pages.clear();
+}
+
+
+TextureAtlas::Page TextureAtlas::newPage() {
+	using namespace TextureAtlasSettings;
+	Page page;
+	page.tex = SDL_CreateTexture(SDL::renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, pageSize, pageSize);
+	if (page.tex == nullptr)
+		Logger::instance().exit(SDLError{"unable to create atlas page", SDLFunc::SDL_CreateTexture});
+	SDL_SetTextureBlendMode(page.tex, SDL_BLENDMODE_BLEND);
+	resetSkyline(page);
+	return page;
+}
+
+
+void TextureAtlas::resetSkyline(Page& page) {
+	page.skyline.assign(1, Segment{0, 0, TextureAtlasSettings::pageSize});
+	page.regions = 0;
+}
+
+
+// Find a place for a w by h area in page and raise the skyline over it
+bool TextureAtlas::place(Page& page, const int w, const int h, SDL_Rect& area) {
+	using namespace TextureAtlasSettings;
+	std::vector<Segment>& sky = page.skyline;
+	std::size_t best = sky.size();
+	int bestY = pageSize;
+	for (std::size_t i = 0; i < sky.size(); ++i) {
+		const int y = fit(sky, i, w);
+		if ((y >= 0) && ((y + h) <= pageSize) && (y < bestY)) {
+			best = i;
+			bestY = y;
+		}
+	}
+	if (best == sky.size())
+		return false;
+	area = SDL_Rect{sky[best].x, bestY, w, h};
+	// segments under the area are replaced by one on top of it
+	const int right = (area.x + w);
+	std::size_t end = best;
+	while ((end < sky.size()) && ((sky[end].x + sky[end].w) <= right))
+		++end;
+	if ((end < sky.size()) && (sky[end].x < right)) {
+		sky[end].w -= (right - sky[end].x);
+		sky[end].x = right;
+	}
+	const auto it = sky.erase(
+		(sky.begin() + static_cast<std::ptrdiff_t>(best)),
+		(sky.begin() + static_cast<std::ptrdiff_t>(end))
+	);
+	sky.insert(it, Segment{area.x, bestY + h, w});
+	for (std::size_t i = 1; i < sky.size();) {
+		if (sky[i - 1].y == sky[i].y) {
+			sky[i - 1].w += sky[i].w;
+			sky.erase(sky.begin() + static_cast<std::ptrdiff_t>(i));
+		}
+		else {
+			++i;
+		}
+	}
+	return true;
+}
+
+
+// Lowest y an area of width w can be at when its left edge is at segment i,
+//   -1 if it goes past the right of the page
+int TextureAtlas::fit(const std::vector<Segment>& sky, std::size_t i, const int w) {
+	if ((sky[i].x + w) > TextureAtlasSettings::pageSize)
+		return -1;
+	int y = 0;
+	for (int left = w; left > 0; ++i) {
+		assert(i < sky.size());
+		y = std::max(y, sky[i].y);
+		left -= sky[i].w;
+	}
+	return y;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "constants.h"	// maxIndex
+#include "sdl_header.h"
+#include <cstddef>
+#include <vector>
+
+
+namespace TextureAtlasSettings {
+	constexpr int pageSize = 1024;	// width and height of page textures
+	constexpr int padding = 1;	// transparent border around each image, so filtering doesn't bleed
+}
+
+
+// Where an image is in the atlas
+struct AtlasRegion {
+	SDL_Texture* tex = nullptr;
+	SDL_Rect rect = {0, 0, 0, 0};
+	std::size_t page = Constants::maxIndex;	// maxIndex if tex is the image's own texture
+};
+
+
+// Packs images into a few large textures (pages), so sprites from different images
+//   can be drawn without switching textures.
+// Pages are packed with a skyline, the top edge of the used area as a list of
+//   segments. An image goes where its top ends lowest, leftmost on ties. Space is
+//   only reclaimed once every image of a page is removed, the page is then reused.
+// Images that don't fit in a page get their own texture.
+class TextureAtlas {
+	TextureAtlas(const TextureAtlas&) = delete;
+	void operator=(const TextureAtlas&) = delete;
+
+	struct Segment {
+		int x;
+		int y;
+		int w;
+	};
+
+	struct Page {
+		SDL_Texture* tex;
+		std::vector<Segment> skyline;	// ordered by x, covers the page width
+		std::size_t regions;	// added and not removed yet
+	};
+public:
+	TextureAtlas() = default;
+	~TextureAtlas();
+	AtlasRegion add(SDL_Surface*);	// does not take ownership of surface
+	void remove(const AtlasRegion&);
+	std::size_t pageCount(void) const;
+	void clear(void);
+private:
+	static Page newPage(void);
+	static void resetSkyline(Page&);
+	static bool place(Page&, const int, const int, SDL_Rect&);
+	static int fit(const std::vector<Segment>&, std::size_t, const int);
+
+	std::vector<Page> pages;
+};
+
+
+inline
+std::size_t TextureAtlas::pageCount() const {
+	return pages.size();
+}
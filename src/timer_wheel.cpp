@@ -0,0 +1,162 @@
+#include "timer_wheel.h"
+#include <algorithm>	// fill, max
+#include <cassert>
+#include <cmath>	// llround
+#include <utility>	// move
+
+
+constexpr TimerWheel::index_type TimerWheel::none;
+
+
+TimerWheel::TimerWheel() {
+	heads.fill(none);
+}
+
+
+// Call callback after delay seconds, rounded to ms (at least 1 ms)
+TimerWheel::Handle TimerWheel::add(const Constants::float_type delay, Callback callback) {
+	assert(delay >= 0);
+	assert(callback);
+	const uint64_t ms = static_cast<uint64_t>(std::llround(static_cast<double>(delay) * 1000));
+	const index_type i = newNode();
+	Node& n = nodes[i];
+	n.callback = std::move(callback);
+	n.deadline = now + std::max(ms, uint64_t{1});
+	insert(i);
+	++count;
+	Handle h;
+	h.index = i;
+	h.generation = n.generation;
+	return h;
+}
+
+
+void TimerWheel::cancel(Handle& h) {
+	if (pending(h)) {
+		unlink(h.index);
+		freeNode(h.index);
+		--count;
+	}
+	h = Handle{};
+}
+
+
+bool TimerWheel::pending(const Handle& h) const {
+	return ((h.index < nodes.size()) && (nodes[h.index].generation == h.generation));
+}
+
+
+// Advance time by dt seconds, firing the timers whose deadline is reached
+void TimerWheel::update(const Constants::float_type dt) {
+	using namespace TimerWheelSettings;
+	elapsed += (static_cast<double>(dt) * 1000);
+	const uint64_t target = static_cast<uint64_t>(elapsed);
+	while (now < target) {
+		++now;
+		// higher levels first, their timers may land in a lower level slot cascaded next
+		for (int level = levels - 1; level > 0; --level) {
+			if ((now & ((uint64_t{1} << (slotBits * level)) - 1)) == 0)
+				cascade(slotIndex(level, now));
+		}
+		fire(slotIndex(0, now));
+	}
+}
+
+
+// Nodes are kept, so handles of the canceled timers stay invalid
+void TimerWheel::clear() {
+	heads.fill(none);
+	for (std::size_t i = 0; i < nodes.size(); ++i) {
+		if (nodes[i].slot != none)
+			freeNode(static_cast<index_type>(i));
+	}
+	count = 0;
+}
+
+
+// Link node into the slot for its deadline.
+// Level k holds deadlines less than slots^(k + 1) ms away, in the slot of their
+//   level k block, which cascades when time enters that block.
+void TimerWheel::insert(const index_type i) {
+	using namespace TimerWheelSettings;
+	const uint64_t deadline = nodes[i].deadline;
+	const uint64_t delta = deadline - now;
+	int level = 0;
+	while ((level < (levels - 1)) && (delta >= (uint64_t{1} << (slotBits * (level + 1)))))
+		++level;
+	// further than the top level covers: cascades early and is inserted again
+	link(i, slotIndex(level, deadline));
+}
+
+
+void TimerWheel::link(const index_type i, const index_type slot) {
+	Node& n = nodes[i];
+	n.slot = slot;
+	n.prev = none;
+	n.next = heads[slot];
+	if (n.next != none)
+		nodes[n.next].prev = i;
+	heads[slot] = i;
+}
+
+
+void TimerWheel::unlink(const index_type i) {
+	Node& n = nodes[i];
+	assert(n.slot != none);
+	if (n.prev != none)
+		nodes[n.prev].next = n.next;
+	else
+		heads[n.slot] = n.next;
+	if (n.next != none)
+		nodes[n.next].prev = n.prev;
+	n.slot = none;
+}
+
+
+// Move the timers of a higher level slot down, list is detached first since
+//   a timer may be inserted back into the same slot
+void TimerWheel::cascade(const index_type slot) {
+	index_type i = heads[slot];
+	heads[slot] = none;
+	while (i != none) {
+		const index_type next = nodes[i].next;
+		nodes[i].slot = none;
+		insert(i);
+		i = next;
+	}
+}
+
+
+// Call the timers of a level 0 slot, taking one at a time so callbacks can
+//   cancel the others
+void TimerWheel::fire(const index_type slot) {
+	while (heads[slot] != none) {
+		const index_type i = heads[slot];
+		assert(nodes[i].deadline == now);
+		unlink(i);
+		Callback callback = std::move(nodes[i].callback);
+		freeNode(i);
+		--count;
+		callback();
+	}
+}
+
+
+TimerWheel::index_type TimerWheel::newNode() {
+	if (freeNodes.empty()) {
+		nodes.push_back(Node{nullptr, 0, none, none, none, 0});
+		return static_cast<index_type>(nodes.size() - 1);
+	}
+	const index_type i = freeNodes.back();
+	freeNodes.pop_back();
+	return i;
+}
+
+
+void TimerWheel::freeNode(const index_type i) {
+	Node& n = nodes[i];
+	n.callback = nullptr;
+	n.slot = none;
+	++n.generation;
+	freeNodes.push_back(i);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "constants.h"
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace TimerWheelSettings {
+	constexpr int slotBits = 6;
+	constexpr unsigned int slots = (1u << slotBits);	// per level
+	constexpr int levels = 4;	// delays up to slots^levels ms (~4.6 hours) without cascading again
+}
+
+
+// Hierarchical timing wheel of callbacks, with millisecond resolution.
+// Level 0 has a slot for each of the next ms, each higher level has slots covering
+//   slots times as long. When time enters a higher level slot its timers cascade
+//   down to the lower levels, so advancing costs the timers that fire or cascade
+//   rather than all pending timers.
+// Callbacks are called from update(), and may add or cancel timers.
+class TimerWheel {
+	TimerWheel(const TimerWheel&) = delete;
+	void operator=(const TimerWheel&) = delete;
+
+	typedef uint32_t index_type;
+	static constexpr index_type none = UINT32_MAX;
+
+	struct Node {
+		std::function<void(void)> callback;
+		uint64_t deadline;	// ms
+		index_type prev;
+		index_type next;
+		index_type slot;	// none if not pending
+		uint32_t generation;	// incremented when node is freed
+	};
+public:
+	typedef std::function<void(void)> Callback;
+
+	// Refers to a timer, invalid once it fires or is canceled
+	struct Handle {
+		index_type index = none;
+		uint32_t generation = 0;
+	};
+
+	TimerWheel();
+	~TimerWheel() = default;
+	Handle add(const Constants::float_type, Callback);	// seconds from now
+	void cancel(Handle&);	// resets handle
+	bool pending(const Handle&) const;
+	void update(const Constants::float_type);
+	void clear(void);
+	uint64_t getTime(void) const;	// ms
+	std::size_t size(void) const;
+private:
+	void insert(const index_type);
+	void link(const index_type, const index_type);
+	void unlink(const index_type);
+	void cascade(const index_type);
+	void fire(const index_type);
+	index_type newNode(void);
+	void freeNode(const index_type);
+	static index_type slotIndex(const int, const uint64_t);
+
+	std::array<index_type, TimerWheelSettings::slots * TimerWheelSettings::levels> heads;
+	std::vector<Node> nodes;
+	std::vector<index_type> freeNodes;
+	double elapsed = 0;	// ms, time given to update()
+	uint64_t now = 0;	// ms, last time processed
+	std::size_t count = 0;
+};
+
+
+inline
+uint64_t TimerWheel::getTime() const {
+	return now;
+}
+
+
+inline
+std::size_t TimerWheel::size() const {
+	return count;
+}
+
+
+// Slot of level holding time ms
+inline
+TimerWheel::index_type TimerWheel::slotIndex(const int level, const uint64_t ms) {
+	using namespace TimerWheelSettings;
+	return static_cast<index_type>((static_cast<unsigned int>(level) * slots) + ((ms >> (slotBits * level)) & (slots - 1)));
+}
@@ -0,0 +1,242 @@
+#include "trace.h"
+#include "console.h"
+#include "exception.h"
+#include "logger.h"
+#include "utility.h"	// q
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>	// strncpy
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace TraceHelper {
+
+struct Event {
+	Uint64 time;
+	const char* name;
+	char phase;	// 'B' begin, 'E' end
+	char detail[TraceSettings::detailLen];
+};
+
+
+// Single producer (owning thread), single consumer (flush) ring buffer
+struct Buffer {
+	std::array<Event, TraceSettings::bufferSize> events;
+	std::atomic<std::size_t> head{0};	// next write, only changed by owner
+	std::atomic<std::size_t> tail{0};	// next read, only changed by flush
+	std::atomic<std::size_t> dropped{0};
+	std::size_t reserved = 0;	// slots kept for end events of open scopes, only used by owner
+	std::size_t skipDepth = 0;	// open scopes that were dropped, only used by owner
+	int tid = 0;
+	bool named = false;	// thread name metadata written?
+};
+
+
+static std::ofstream file;
+static std::mutex mutex;	// guards buffers, file
+static std::vector<std::unique_ptr<Buffer>> buffers;
+static thread_local Buffer* threadBuffer = nullptr;
+static Uint64 startCount = 0;
+static double usPerCount = 0;
+static bool firstEvent = true;
+
+
+// registering a thread is the only time recording locks
+static Buffer* getBuffer() {
+	if (threadBuffer == nullptr) {
+		std::lock_guard<std::mutex> lock{mutex};
+		buffers.emplace_back(new Buffer);
+		threadBuffer = buffers.back().get();
+		threadBuffer->tid = static_cast<int>(buffers.size() - 1);
+	}
+	return threadBuffer;
+}
+
+
+// events in buf, may be less than that while the owner records
+static std::size_t used(const Buffer& buf) {
+	const std::size_t head = buf.head.load(std::memory_order_acquire);
+	const std::size_t tail = buf.tail.load(std::memory_order_acquire);
+	return (head + TraceSettings::bufferSize - tail) % TraceSettings::bufferSize;
+}
+
+
+// Record a begin event unless the buffer can't also hold its end event and the
+//   end events already reserved, then the scope and every scope in it is dropped.
+// End events always have a reserved slot, so recorded scopes are always closed.
+static void add(const char phase, const char* name, const char* detail) {
+	Buffer* buf = getBuffer();
+	if (phase == 'B') {
+		// flush only makes room, so the free space can't be less than this
+		const std::size_t free = TraceSettings::bufferSize - 1 - used(*buf);
+		if ((buf->skipDepth > 0) || (free < buf->reserved + 2)) {
+			++buf->skipDepth;
+			buf->dropped.fetch_add(2, std::memory_order_relaxed);
+			return;
+		}
+		++buf->reserved;
+	}
+	else {
+		if (buf->skipDepth > 0) {
+			--buf->skipDepth;
+			return;
+		}
+		assert(buf->reserved > 0);
+		--buf->reserved;
+	}
+	const std::size_t head = buf->head.load(std::memory_order_relaxed);
+	const std::size_t next = (head + 1) % TraceSettings::bufferSize;
+	assert(next != buf->tail.load(std::memory_order_acquire));
+	Event& e = buf->events[head];
+	e.time = SDL_GetPerformanceCounter();
+	e.name = name;
+	e.phase = phase;
+	if (detail != nullptr) {
+		std::strncpy(e.detail, detail, TraceSettings::detailLen - 1);
+		e.detail[TraceSettings::detailLen - 1] = '\0';
+	}
+	else {
+		e.detail[0] = '\0';
+	}
+	buf->head.store(next, std::memory_order_release);
+}
+
+
+static void writeEscaped(std::ostream& os, const char* str) {
+	for (; *str != '\0'; ++str) {
+		const char c = *str;
+		if ((c == '"') || (c == '\\'))
+			os << '\\' << c;
+		else if (static_cast<unsigned char>(c) < 0x20)
+			os << ' ';
+		else
+			os << c;
+	}
+}
+
+
+static void beginRecord() {
+	if (firstEvent)
+		firstEvent = false;
+	else
+		file << ",\n";
+}
+
+
+static void writeEvent(const Event& e, const int tid) {
+	beginRecord();
+	file << "{\"name\":\"";
+	writeEscaped(file, e.name);
+	file << "\",\"cat\":\"mr\",\"ph\":\"" << e.phase << "\",\"ts\":"
+	     << (static_cast<double>(e.time - startCount) * usPerCount)
+	     << ",\"pid\":1,\"tid\":" << tid;
+	if (e.detail[0] != '\0') {
+		file << ",\"args\":{\"detail\":\"";
+		writeEscaped(file, e.detail);
+		file << "\"}";
+	}
+	file << '}';
+}
+
+
+static void writeThreadName(Buffer& buf) {
+	beginRecord();
+	file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buf.tid
+	     << ",\"args\":{\"name\":\"";
+	if (buf.tid == 0)
+		file << "main";	// first thread to record
+	else
+		file << "thread " << buf.tid;
+	file << "\"}}";
+	buf.named = true;
+}
+
+}	// namespace TraceHelper
+
+
+bool Trace::enabled = false;
+
+
+void Trace::open(const std::string& path) {
+	using namespace TraceHelper;
+	assert(!enabled);
+	file.open(path, std::ofstream::out | std::ofstream::trunc);
+	if (!file.is_open()) {
+		Logger::instance().log(FileError{path, FileError::Err::NOT_OPEN});
+		return;
+	}
+	file.precision(3);
+	file << std::fixed << "[\n";
+	startCount = SDL_GetPerformanceCounter();
+	usPerCount = 1000000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	firstEvent = true;
+	enabled = true;
+	Console::begin() << "tracing to " << q(path) << ", flush with "
+	                 << SDL_GetKeyName(TraceSettings::flushKey) << std::endl;
+}
+
+
+void Trace::close() {
+	using namespace TraceHelper;
+	if (!enabled)
+		return;
+	flush();
+	enabled = false;
+	std::lock_guard<std::mutex> lock{mutex};
+	file << "\n]\n";
+	file.close();
+}
+
+
+void Trace::begin(const char* name, const char* detail) {
+	TraceHelper::add('B', name, detail);
+}
+
+
+void Trace::end(const char* name) {
+	TraceHelper::add('E', name, nullptr);
+}
+
+
+// Safe to call from any thread, events recorded during flush are kept for the next one
+void Trace::flush() {
+	using namespace TraceHelper;
+	if (!enabled)
+		return;
+	std::lock_guard<std::mutex> lock{mutex};
+	for (auto& p : buffers) {
+		Buffer& buf = *p;
+		if (!buf.named)
+			writeThreadName(buf);
+		const std::size_t head = buf.head.load(std::memory_order_acquire);
+		std::size_t tail = buf.tail.load(std::memory_order_relaxed);
+		for (; tail != head; tail = (tail + 1) % TraceSettings::bufferSize)
+			writeEvent(buf.events[tail], buf.tid);
+		buf.tail.store(tail, std::memory_order_release);
+		// a dropped scope is counted as 2 events when it begins
+		const std::size_t dropped = buf.dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped > 0)
+			Console::begin() << "trace: dropped " << dropped << " events on thread " << buf.tid << std::endl;
+	}
+	file.flush();
+}
+
+
+// Writing is done between frames, before a busy frame can fill a buffer and drop scopes
+void Trace::drain() {
+	using namespace TraceHelper;
+	if (!enabled)
+		return;
+	bool full = false;
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		for (const auto& p : buffers)
+			full = (full || (used(*p) > (TraceSettings::bufferSize / 2)));
+	}
+	if (full)
+		flush();
+}
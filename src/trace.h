@@ -0,0 +1,72 @@
+#pragma once
+
+#include "sdl_header.h"
+#include <string>
+
+
+namespace TraceSettings {
+	constexpr SDL_Keycode flushKey = SDLK_F9;
+	constexpr std::size_t bufferSize = 16 * 1024;	// events per thread
+	constexpr std::size_t detailLen = 48;	// max length of detail string, including null
+}
+
+
+// Writes begin/end events as Chrome trace-event JSON (view in chrome://tracing or Perfetto).
+// Each thread records into its own fixed-size buffer without locking, flush()
+//   moves the recorded events to the file. When a buffer is full whole scopes are
+//   dropped, a begin event is only recorded if there is room for its end event
+//   and the end events of the scopes around it.
+// The file uses the JSON array format, so it can be viewed after any flush.
+class Trace {
+public:
+	static void open(const std::string&);
+	static void close(void);	// flush and finish file
+	static bool isEnabled(void);
+	// name must be a string literal, detail is copied (and truncated)
+	static void begin(const char*, const char* = nullptr);
+	static void end(const char*);
+	static void flush(void);
+	static void drain(void);	// flush if a buffer is more than half full, call from the main thread
+private:
+	static bool enabled;
+};
+
+
+// Begin event on construction, end event on destruction
+class TraceScope {
+	TraceScope(const TraceScope&) = delete;
+	void operator=(const TraceScope&) = delete;
+public:
+	TraceScope(const char*, const char* = nullptr);
+	TraceScope(const char*, const std::string&);
+	~TraceScope();
+private:
+	const char* name;
+};
+
+
+inline
+bool Trace::isEnabled() {
+	return enabled;
+}
+
+
+inline
+TraceScope::TraceScope(const char* n, const char* detail) : name(n) {
+	if (Trace::isEnabled())
+		Trace::begin(name, detail);
+}
+
+
+inline
+TraceScope::TraceScope(const char* n, const std::string& detail) : name(n) {
+	if (Trace::isEnabled())
+		Trace::begin(name, detail.c_str());
+}
+
+
+inline
+TraceScope::~TraceScope() {
+	if (Trace::isEnabled())
+		Trace::end(name);
+}
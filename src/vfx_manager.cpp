@@ -5,18 +5,21 @@
 
 VFXManager::~VFXManager() {
 	for (auto& v : list)
-		delete v;
+		release(v);
 }
 
 
 void VFXManager::update(const Constants::float_type dt) {
-	for (auto it = list.begin(); it != list.end();) {
-		if ((**it).update(dt)) {
-			delete *it;
-			it = list.erase(it);
+	// removed effects are replaced with the last one, which is updated next
+	for (std::size_t i = 0; i < list.size();) {
+		if (list[i]->update(dt)) {
+			release(list[i]);
+			list[i] = list.back();
+			list.pop_back();
+		}
+		else {
+			++i;
 		}
-		else
-			++it;
 	}
 }
 
@@ -27,6 +30,22 @@ void VFXManager::draw(Canvas& can) {
 }
 
 
+VFXFade* VFXManager::newFade() {
+	return fades.create();
+}
+
+
 void VFXManager::add(Entity* vfx) {
 	list.push_back(vfx);
 }
+
+
+// Give an effect back to its pool, effects not from a pool are deleted.
+// Fades are only created by newFade().
+void VFXManager::release(Entity* vfx) {
+	VFXFade* fade = dynamic_cast<VFXFade*>(vfx);
+	if (fade != nullptr)
+		fades.destroy(fade);
+	else
+		delete vfx;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "constants.h"
-#include <list>
+#include "object_pool.h"
+#include "vfx_fade.h"
+#include <vector>
 
 
 class Canvas;
@@ -9,6 +11,7 @@ class Entity;
 
 
 // Visual Effects Manager
+// Fades are created from a pool, so spells hitting doesn't allocate once it has grown.
 class VFXManager {
 	VFXManager(const VFXManager&) = delete;
 	void operator=(const VFXManager&) = delete;
@@ -17,7 +20,11 @@ public:
 	~VFXManager();
 	void update(const Constants::float_type);
 	void draw(Canvas&);
+	VFXFade* newFade(void);	// pass to add() when set up
 	void add(Entity*);
 private:
-	std::list<Entity*> list;
+	void release(Entity*);
+
+	ObjectPool<VFXFade> fades;
+	std::vector<Entity*> list;	// added effects, unordered
 };
@@ -25,13 +25,13 @@ TextEdit::TextEdit() : offsetX(3 + TextEditSettings::outlineSz) {
 
 TextEdit::~TextEdit() {
 	// do not delete tr
-	SDL::freeNull(tex);
 	disableTextInput();
 }
 
 
 void TextEdit::setRenderer(TextRenderer* const p) {
 	tr = p;
+	texBounds.h = tr->getMetrics().height;
 	if (sizePolicy != WidgetSizePolicy::FIXED) {
 		if (_getParent() != nullptr)
 			_getParent()->_requestResize(this, getPrefSize());
@@ -78,8 +78,10 @@ void TextEdit::draw(Canvas& can) {
 		bounds.w - (outlineSz * 2),
 		bounds.h - (outlineSz * 2)
 	);
-	if (tex != nullptr)
-		can.draw(tex, &texBounds);
+	if (!strText.empty()) {
+		tr->setColor(colText);
+		tr->draw(can, strText, texBounds.x, texBounds.y);
+	}
 }
 
 
@@ -129,31 +131,15 @@ void TextEdit::_resize(const IntPair& p, const WidgetResizeFlag) {
 	assert((p.first > 0) && (p.second > 0));
 	bounds.w = p.first;
 	bounds.h = p.second;
-	if (tex != nullptr) {
-		texBounds.y = ((bounds.h - texBounds.h) / 2);
-	}
+	texBounds.y = ((bounds.h - texBounds.h) / 2);
 }
 
 
+// Only measures the text, it is drawn from the glyph atlas of tr
 void TextEdit::updateText() {
-	if (strText.empty()) {
-		SDL::freeNull(tex);
-		tex = nullptr;
-	}
-	else {
-		tr->setColor(colText);
-		SDL_Surface* surf = tr->render(strText);
-		SDL::freeNull(tex);
-		if (surf == nullptr) {
-			tex = nullptr;
-		}
-		else {
-			texBounds.w = surf->w;
-			texBounds.h = surf->h;
-			texBounds.y = ((bounds.h - texBounds.h) / 2);
-			tex = SDL::toTexture(surf);
-		}
-	}
+	texBounds.w = tr->drawWidth(strText);
+	texBounds.h = tr->getMetrics().height;
+	texBounds.y = ((bounds.h - texBounds.h) / 2);
 }
 
 
@@ -36,7 +36,6 @@ private:
 	std::string strText;
 	SDL_Rect texBounds;
 	TextRenderer* tr = nullptr;
-	SDL_Texture* tex = nullptr;
 	int offsetX;
 	int paddingV = 3;
 	Color colText;
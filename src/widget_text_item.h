@@ -14,7 +14,6 @@ class TextItem : public WidgetWithVisibility {
 	void operator=(const TextItem&) = delete;
 public:
 	TextItem();
-	~TextItem();
 	void setText(const std::string&);
 	const std::string& getText(void) const;
 	// Widget implementation
@@ -29,7 +28,6 @@ private:
 
 	std::string text;
 	SDL_Rect textBounds;
-	SDL_Texture* tex = nullptr;
 };
 
 
@@ -211,9 +211,14 @@ void TextListView::_resize(const IntPair& p, const WidgetResizeFlag) {
 
 
 //! TODO limit text size
-SDL_Surface* TextListView::renderText(const std::string& str) {
+void TextListView::drawText(Canvas& can, const std::string& str, const int x, const int y) {
 	tr.setColor(colText);
-	return tr.render(str);
+	tr.draw(can, str, x, y);
+}
+
+
+int TextListView::textWidth(const std::string& str) {
+	return tr.drawWidth(str);
 }
 
 
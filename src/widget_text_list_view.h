@@ -22,7 +22,7 @@ struct DrawRange {
 class TextListView : public Widget {
 	TextListView(const TextListView&) = delete;
 	void operator=(const TextListView&) = delete;
-	friend class TextItem;	// only for renderText()
+	friend class TextItem;	// only for drawText() and textWidth()
 public:
 	typedef std::function<void(TextItem*)> SelectedCallback;
 	TextListView();
@@ -44,7 +44,8 @@ public:
 	IntPair getMinSize(void) const override;
 	void _resize(const IntPair&, const WidgetResizeFlag) override;
 private:
-	SDL_Surface* renderText(const std::string&);	// called by TextItem
+	void drawText(Canvas&, const std::string&, const int, const int);	// called by TextItem
+	int textWidth(const std::string&);	// called by TextItem
 	void scrollBarCallback(const int);
 	void setDownItem(const std::size_t);
 	int getItemWidth(void) const;
@@ -0,0 +1,66 @@
+#include "worker_pool.h"
+#include <cassert>
+
+
+WorkerPool::WorkerPool(const unsigned int count) {
+	assert(count > 0);
+	for (unsigned int i = 1; i < count; ++i)
+		threads.emplace_back(&WorkerPool::work, this);
+}
+
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		quit = true;
+	}
+	wake.notify_all();
+	for (auto& t : threads)
+		t.join();
+}
+
+
+void WorkerPool::run(const std::size_t count, const Job& j) {
+	if (threads.empty() || (count < 2)) {
+		for (std::size_t i = 0; i < count; ++i)
+			j(i);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		job = &j;
+		jobCount = count;
+		nextJob.store(0);
+		finished = 0;
+		++generation;
+	}
+	wake.notify_all();
+	doJobs();
+	// wait for every thread, so none is left holding this run's job
+	std::unique_lock<std::mutex> lock{mutex};
+	done.wait(lock, [this] {return (finished == threads.size());});
+	job = nullptr;
+}
+
+
+void WorkerPool::work() {
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock{mutex};
+	while (true) {
+		wake.wait(lock, [this, &seen] {return (quit || (generation != seen));});
+		if (quit)
+			return;
+		seen = generation;
+		lock.unlock();
+		doJobs();
+		lock.lock();
+		if (++finished == threads.size())
+			done.notify_all();
+	}
+}
+
+
+void WorkerPool::doJobs() {
+	for (std::size_t i = nextJob.fetch_add(1); i < jobCount; i = nextJob.fetch_add(1))
+		(*job)(i);
+}
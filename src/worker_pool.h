@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Threads that run numbered jobs in parallel, the calling thread works on them too.
+// run() returns after all jobs are done, jobs are taken in order but may finish in any.
+class WorkerPool {
+	WorkerPool(const WorkerPool&) = delete;
+	void operator=(const WorkerPool&) = delete;
+public:
+	typedef std::function<void(const std::size_t)> Job;
+
+	WorkerPool(const unsigned int);	// number of threads, including the caller
+	~WorkerPool();
+	unsigned int size(void) const;
+	void run(const std::size_t, const Job&);
+private:
+	void work(void);
+	void doJobs(void);
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;	// guards everything below but nextJob
+	std::condition_variable wake;
+	std::condition_variable done;
+	const Job* job = nullptr;
+	std::size_t jobCount = 0;
+	std::atomic<std::size_t> nextJob{0};
+	std::size_t finished = 0;	// threads done with current run
+	uint64_t generation = 0;	// incremented by each run
+	bool quit = false;
+};
+
+
+inline
+unsigned int WorkerPool::size() const {
+	return static_cast<unsigned int>(threads.size() + 1);
+}